@@ -0,0 +1,108 @@
+#ifndef BOSON_BARRIER_H_
+#define BOSON_BARRIER_H_
+#include <atomic>
+#include "semaphore.h"
+
+namespace boson {
+
+namespace internal {
+namespace select_impl {
+template <class>
+class event_barrier_wait_storage;
+}
+
+/**
+ * One phase of a barrier
+ *
+ * The last routine to arrive installs the next phase and disables the gate
+ * of this one, which wakes up every routine waiting on it.
+ */
+struct barrier_phase {
+  std::atomic<int> remaining_;
+  semaphore gate_;
+
+  inline barrier_phase(int nb_participants);
+};
+
+barrier_phase::barrier_phase(int nb_participants) : remaining_{nb_participants}, gate_{0} {
+}
+
+struct barrier_state {
+  int const nb_participants_;
+  std::shared_ptr<barrier_phase> phase_;
+
+  barrier_state(int nb_participants);
+};
+
+}  // namespace internal
+
+class barrier;
+
+/**
+ * Identifies the phase a routine arrived at
+ */
+class barrier_token {
+  friend class barrier;
+  template <class>
+  friend class internal::select_impl::event_barrier_wait_storage;
+  std::shared_ptr<internal::barrier_phase> phase_;
+
+  inline barrier_token(std::shared_ptr<internal::barrier_phase> phase);
+};
+
+barrier_token::barrier_token(std::shared_ptr<internal::barrier_phase> phase)
+    : phase_{std::move(phase)} {
+}
+
+/**
+ * Reusable barrier for a fixed number of routines
+ *
+ * Each phase completes once every participant arrived. Arriving and waiting
+ * can be done separately, the token given by arrive() is waited for later,
+ * or in a select statement.
+ */
+class barrier {
+  std::shared_ptr<internal::barrier_state> impl_;
+
+ public:
+  barrier(int nb_participants);
+  barrier(barrier const&) = default;
+  barrier(barrier&&) = default;
+  barrier& operator=(barrier const&) = default;
+  barrier& operator=(barrier&&) = default;
+  ~barrier() = default;
+
+  /**
+   * Counts the routine as arrived at the current phase, never suspends
+   */
+  barrier_token arrive();
+
+  /**
+   * Suspends the routine until the phase of the token completes
+   *
+   * On timeout, the arrival is still counted.
+   */
+  semaphore_result wait(barrier_token const& token, int timeout = -1);
+  inline semaphore_result wait(barrier_token const& token, std::chrono::milliseconds timeout);
+
+  inline semaphore_result arrive_and_wait(int timeout = -1);
+  inline semaphore_result arrive_and_wait(std::chrono::milliseconds timeout);
+};
+
+// inline implementations
+
+semaphore_result barrier::wait(barrier_token const& token, std::chrono::milliseconds timeout) {
+  return wait(token, timeout.count());
+}
+
+semaphore_result barrier::arrive_and_wait(int timeout) {
+  return wait(arrive(), timeout);
+}
+
+semaphore_result barrier::arrive_and_wait(std::chrono::milliseconds timeout) {
+  return wait(arrive(), timeout.count());
+}
+
+}  // namespace boson
+
+#endif  // BOSON_BARRIER_H_
@@ -0,0 +1,391 @@
+#ifndef BOSON_BROADCAST_CHANNEL_H_
+#define BOSON_BROADCAST_CHANNEL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+#include "channel.h"
+#include "select.h"
+#include "semaphore.h"
+
+namespace boson {
+
+/**
+ * What happens to a subscriber too slow to keep up with the ring
+ */
+enum class broadcast_lag_policy {
+  skip,  // It skips the overwritten elements and goes on with the oldest one
+  drop   // It is unsubscribed, its reads fail as if the channel were closed
+};
+
+template <class ContentType>
+class broadcast_subscriber;
+
+namespace internal {
+namespace select_impl {
+template <class ContentType, class Func>
+class event_broadcast_read_storage;
+}
+
+/**
+ * Semaphore never holding any ticket, disabled to wake up every waiter
+ *
+ * A gate is opened once the element of its sequence is published.
+ */
+struct broadcast_gate {
+  semaphore sema{0};
+  std::uint64_t sequence;
+
+  inline broadcast_gate(std::uint64_t new_sequence) : sequence{new_sequence} {
+  }
+};
+
+inline std::shared_ptr<broadcast_gate> make_broadcast_gate(std::uint64_t sequence) {
+  auto gate = std::make_shared<broadcast_gate>(sequence);
+  gate->sema.set_owner(gate);
+  return gate;
+}
+
+template <class ContentType>
+class broadcast_state {
+  template <class Content>
+  friend class boson::broadcast_subscriber;
+  template <class Content, class Func>
+  friend class select_impl::event_broadcast_read_storage;
+
+  static constexpr std::uint64_t const writing = std::numeric_limits<std::uint64_t>::max();
+
+  struct slot {
+    std::atomic<std::uint64_t> sequence{writing};
+    std::shared_ptr<ContentType const> value;
+  };
+
+  std::vector<slot> ring_;
+  broadcast_lag_policy policy_;
+  // Sequences taken by writers, published ones, and the writer whose turn it is
+  std::atomic<std::uint64_t> claimed_{0};
+  std::atomic<std::uint64_t> next_{0};
+  std::atomic<std::uint64_t> turn_{0};
+  std::atomic<bool> closed_{false};
+
+  /**
+   * Readers wait on the gate of the next sequence
+   *
+   * Every write replaces it and disables the old one, which wakes up every
+   * waiting reader at once. A reader giving up just leaves the gate, there
+   * is no waiter count to maintain.
+   */
+  std::shared_ptr<broadcast_gate> gate_{make_broadcast_gate(0)};
+
+  void open_gate(std::uint64_t next_sequence) {
+    std::atomic_exchange(&gate_, make_broadcast_gate(next_sequence))->sema.disable();
+  }
+
+ public:
+  broadcast_state(std::size_t capacity, broadcast_lag_policy policy)
+      : ring_(capacity), policy_{policy} {
+  }
+
+  /**
+   * Gate to wait on for the element at cursor
+   *
+   * It must be taken before checking for new elements. The gate of a
+   * sequence already read is about to be replaced by its writer.
+   */
+  std::shared_ptr<broadcast_gate> gate(std::uint64_t cursor) {
+    for (;;) {
+      auto current = std::atomic_load(&gate_);
+      if (cursor <= current->sequence) return current;
+    }
+  }
+
+  channel_result write(std::shared_ptr<ContentType const> value) {
+    if (closed_.load()) return {channel_result_value::closed};
+    // Writers take turns in sequence order, none of them suspends meanwhile
+    std::uint64_t sequence = claimed_.fetch_add(1);
+    while (turn_.load(std::memory_order_acquire) != sequence) {
+    }
+    slot& target = ring_[sequence % ring_.size()];
+    // Readers check the sequence around their load, like a seqlock
+    target.sequence.store(writing);
+    std::atomic_store(&target.value, std::move(value));
+    target.sequence.store(sequence);
+    next_.store(sequence + 1);
+    open_gate(sequence + 1);
+    turn_.store(sequence + 1, std::memory_order_release);
+    return {channel_result_value::ok};
+  }
+
+  void close() {
+    closed_.store(true);
+    // Readers see the channel closed before waiting on the new gate
+    open_gate(std::numeric_limits<std::uint64_t>::max());
+  }
+
+  std::uint64_t next() const {
+    return next_.load();
+  }
+
+  std::size_t capacity() const {
+    return ring_.size();
+  }
+
+  /**
+   * Reads the element at cursor without waiting
+   *
+   * Moves cursor past the element, or forward if it lags behind the ring.
+   * Returns ok, timedout if there is nothing yet, or closed.
+   */
+  channel_result_value try_read(std::uint64_t& cursor, std::size_t& nb_lost, bool& dropped,
+                                std::shared_ptr<ContentType const>& value) {
+    for (;;) {
+      if (dropped) return channel_result_value::closed;
+      std::uint64_t next = next_.load();
+      if (next <= cursor) {
+        return closed_.load() && next_.load() <= cursor ? channel_result_value::closed
+                                                        : channel_result_value::timedout;
+      }
+      if (ring_.size() < next - cursor) {
+        if (policy_ == broadcast_lag_policy::drop) {
+          dropped = true;
+          continue;
+        }
+        nb_lost += next - ring_.size() - cursor;
+        cursor = next - ring_.size();
+      }
+      slot& source = ring_[cursor % ring_.size()];
+      std::uint64_t before = source.sequence.load();
+      auto loaded = std::atomic_load(&source.value);
+      if (before == cursor && source.sequence.load() == cursor) {
+        value = std::move(loaded);
+        ++cursor;
+        return channel_result_value::ok;
+      }
+      // Overwritten meanwhile, the lag is handled by the next round
+    }
+  }
+};
+
+}  // namespace internal
+
+/**
+ * Reading end of a broadcast channel
+ *
+ * A subscriber has its own position in the channel. Copies of a
+ * subscriber read independently from the position they were copied at.
+ */
+template <class ContentType>
+class broadcast_subscriber {
+  template <class Content, class Func>
+  friend class internal::select_impl::event_broadcast_read_storage;
+
+  using state_t = internal::broadcast_state<ContentType>;
+  std::shared_ptr<state_t> state_;
+  std::uint64_t cursor_;
+  std::size_t nb_lost_ = 0;
+  bool dropped_ = false;
+
+  channel_result_value try_read(std::shared_ptr<ContentType const>& value) {
+    return state_->try_read(cursor_, nb_lost_, dropped_, value);
+  }
+
+ public:
+  broadcast_subscriber(std::shared_ptr<state_t> state)
+      : state_{std::move(state)}, cursor_{state_->next()} {
+  }
+  broadcast_subscriber(broadcast_subscriber const&) = default;
+  broadcast_subscriber(broadcast_subscriber&&) = default;
+  broadcast_subscriber& operator=(broadcast_subscriber const&) = default;
+  broadcast_subscriber& operator=(broadcast_subscriber&&) = default;
+
+  /**
+   * Number of elements skipped because the subscriber lagged behind
+   */
+  inline std::size_t nb_lost() const {
+    return nb_lost_;
+  }
+
+  /**
+   * Tells if the subscriber lagged behind and has been dropped
+   */
+  inline bool dropped() const {
+    return dropped_;
+  }
+
+  /**
+   * Reads the next element
+   *
+   * Fails if the channel is closed and every element has been read, or if
+   * the subscriber has been dropped.
+   */
+  channel_result read(std::shared_ptr<ContentType const>& value, int timeout_ms = -1) {
+    using namespace std::chrono;
+    auto deadline = high_resolution_clock::now() + milliseconds(timeout_ms);
+    for (;;) {
+      auto result = try_read(value);
+      if (result != channel_result_value::timedout) return {result};
+      auto gate = state_->gate(cursor_);
+      // Something may have been written before the gate was taken
+      result = try_read(value);
+      if (result != channel_result_value::timedout) return {result};
+      int remaining = -1;
+      if (0 <= timeout_ms) {
+        remaining = static_cast<int>(std::max<long long>(
+            0, duration_cast<milliseconds>(deadline - high_resolution_clock::now()).count()));
+      }
+      if (gate->sema.wait(remaining) == semaphore_return_value::timedout) {
+        auto result = try_read(value);
+        return {result == channel_result_value::ok ? channel_result_value::ok
+                                                   : channel_result_value::timedout};
+      }
+    }
+  }
+};
+
+/**
+ * Channel delivering every element to every subscriber
+ *
+ * Elements are stored once, as shared immutable values, in a ring which
+ * every subscriber reads at its own pace. Writes never wait: a subscriber
+ * lagging more than the ring capacity behind either skips the overwritten
+ * elements or is dropped, depending on the lag policy. A write wakes every
+ * waiting subscriber at once.
+ *
+ * Subscribers only get the elements written after they subscribed.
+ */
+template <class ContentType>
+class broadcast_channel {
+  using state_t = internal::broadcast_state<ContentType>;
+  std::shared_ptr<state_t> state_;
+
+ public:
+  using value_type = std::shared_ptr<ContentType const>;
+  using subscriber = broadcast_subscriber<ContentType>;
+
+  broadcast_channel(std::size_t capacity,
+                    broadcast_lag_policy policy = broadcast_lag_policy::skip)
+      : state_{std::make_shared<state_t>(capacity, policy)} {
+  }
+  broadcast_channel(broadcast_channel const&) = default;
+  broadcast_channel(broadcast_channel&&) = default;
+  broadcast_channel& operator=(broadcast_channel const&) = default;
+  broadcast_channel& operator=(broadcast_channel&&) = default;
+
+  inline subscriber subscribe() {
+    return {state_};
+  }
+
+  /**
+   * Closes the channel
+   *
+   * Subscribers still get the elements written before.
+   */
+  inline void close() {
+    state_->close();
+  }
+
+  /**
+   * Publishes an element to every subscriber
+   *
+   * Never waits. Returns false only if the channel is closed.
+   */
+  inline channel_result write(std::shared_ptr<ContentType const> value) {
+    return state_->write(std::move(value));
+  }
+
+  inline channel_result write(ContentType value) {
+    return state_->write(std::make_shared<ContentType const>(std::move(value)));
+  }
+};
+
+template <class ContentType, class ValueType>
+inline channel_result operator<<(broadcast_channel<ContentType>& channel, ValueType&& value) {
+  return channel.write(std::forward<ValueType>(value));
+}
+
+template <class ContentType>
+inline channel_result operator>>(broadcast_subscriber<ContentType>& subscriber,
+                                 std::shared_ptr<ContentType const>& value) {
+  return subscriber.read(value);
+}
+
+namespace internal {
+namespace select_impl {
+
+/**
+ * Waits for the next element of a broadcast subscriber
+ *
+ * The event waits on the gate of the channel, taken anew at every round.
+ * The gate is only opened once an element is published, so execute never
+ * waits : it reads what the wake up announced.
+ */
+template <class ContentType, class Func>
+class event_broadcast_read_storage : semaphore_owner_holder<broadcast_gate>,
+                                     public event_semaphore_wait_base_storage {
+  broadcast_subscriber<ContentType>& subscriber_;
+  std::shared_ptr<ContentType const>& value_;
+  channel_result_value result_ = channel_result_value::timedout;
+  Func func_;
+
+ public:
+  using func_type = Func;
+  using return_type = decltype(std::declval<Func>()(bool{}));
+
+  static return_type execute(event_broadcast_read_storage* self, internal::event_type, bool) {
+    if (self->result_ == channel_result_value::timedout)
+      self->result_ = self->subscriber_.try_read(self->value_);
+    return self->func_(self->result_ == channel_result_value::ok);
+  }
+
+  event_broadcast_read_storage(broadcast_subscriber<ContentType>& subscriber,
+                               std::shared_ptr<ContentType const>& value, Func&& cb)
+      : semaphore_owner_holder<broadcast_gate>{subscriber.state_->gate(subscriber.cursor_)},
+        event_semaphore_wait_base_storage{owner_->sema},
+        subscriber_{subscriber},
+        value_{value},
+        func_{std::move(cb)} {
+  }
+
+  event_broadcast_read_storage(broadcast_subscriber<ContentType>& subscriber,
+                               std::shared_ptr<ContentType const>& value, Func const& cb)
+      : semaphore_owner_holder<broadcast_gate>{subscriber.state_->gate(subscriber.cursor_)},
+        event_semaphore_wait_base_storage{owner_->sema},
+        subscriber_{subscriber},
+        value_{value},
+        func_{cb} {
+  }
+
+  bool poll() {
+    result_ = subscriber_.try_read(value_);
+    return result_ != channel_result_value::timedout;
+  }
+
+  bool subscribe(internal::routine* current) {
+    // Writes open the gate after publishing, so it is taken before checking
+    owner_ = subscriber_.state_->gate(subscriber_.cursor_);
+    rebind(owner_->sema);
+    if (poll()) return true;
+    return event_semaphore_wait_base_storage::subscribe(current);
+  }
+};
+
+}  // namespace select_impl
+}  // namespace internal
+
+/**
+ * Reads from a broadcast subscriber in a select_any call
+ */
+template <class ContentType, class Func>
+internal::select_impl::event_broadcast_read_storage<ContentType, Func> event_read(
+    broadcast_subscriber<ContentType>& subscriber, std::shared_ptr<ContentType const>& value,
+    Func&& cb) {
+  return {subscriber, value, std::forward<Func>(cb)};
+}
+
+}  // namespace boson
+
+#endif  // BOSON_BROADCAST_CHANNEL_H_
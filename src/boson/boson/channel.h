@@ -1,13 +1,22 @@
 #ifndef BOSON_CHANNEL_H_
 #define BOSON_CHANNEL_H_
 
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <functional>
+#include <limits>
 #include <list>
 #include <memory>
 #include <mutex>
+#include <vector>
 #include "boson/semaphore.h"
 #include "engine.h"
+#include "exception.h"
 #include "internal/routine.h"
 #include "internal/thread.h"
+#include "queues/segmented_queue.h"
 
 namespace boson {
 
@@ -25,45 +34,113 @@ struct channel_result {
   }
 };
 
+/**
+ * Channel size for a capacity given at construction
+ */
+constexpr std::size_t dynamic_channel_size = std::numeric_limits<std::size_t>::max();
+
+/**
+ * Channel size for a channel without capacity, writes never wait
+ */
+constexpr std::size_t unbounded_channel_size = dynamic_channel_size - 1;
+
+namespace internal {
+
+// Semaphore ticket counts are ints
+inline int ticket_count(std::size_t count) {
+  return static_cast<int>(std::min<std::size_t>(count, std::numeric_limits<int>::max()));
+}
+
+inline channel_result failed_channel_op(semaphore_result ticket) {
+  return {ticket == semaphore_return_value::timedout ? channel_result_value::timedout
+                                                     : channel_result_value::closed};
+}
+
+/**
+ * Ring storage of a buffered channel, inline when the size is static
+ */
+template <class ContentType, std::size_t Size>
+class channel_ring {
+  std::array<ContentType, Size> data_;
+
+ public:
+  channel_ring(std::size_t) : data_{} {
+  }
+
+  inline ContentType& operator[](std::size_t index) {
+    return data_[index % Size];
+  }
+};
+
+template <class ContentType>
+class channel_ring<ContentType, dynamic_channel_size> {
+  std::unique_ptr<ContentType[]> data_;
+  std::size_t capacity_;
+
+ public:
+  channel_ring(std::size_t capacity) : data_{}, capacity_{capacity} {
+    // Unbuffered channels are another implementation, chosen by the size
+    if (0 == capacity) throw exception("A channel with a run time capacity cannot be unbuffered.");
+    data_.reset(new ContentType[capacity]());
+  }
+
+  inline ContentType& operator[](std::size_t index) {
+    return data_[index % capacity_];
+  }
+};
+
+}  // namespace internal
+
 template <class ContentType, std::size_t Size>
 class channel_impl {
-  static_assert(0 < Size, "Boson channels do not support zero size.");
   template <class Content, std::size_t InSize, class Func>
   friend class internal::select_impl::event_channel_read_storage;
   template <class Content, std::size_t InSize, class Func>
   friend class internal::select_impl::event_channel_write_storage;
 
-  std::array<ContentType, Size> buffer_;
+  internal::channel_ring<ContentType, Size> buffer_;
   std::atomic<size_t> head_;
   std::atomic<size_t> tail_;
 
   // Waiting lists
-  boson::shared_semaphore readers_slots_;
-  boson::shared_semaphore writer_slots_;
+  boson::semaphore readers_slots_;
+  boson::semaphore writer_slots_;
 
  public:
-  channel_impl() : buffer_{}, head_{0}, tail_{0}, readers_slots_(0), writer_slots_(Size) {
+  channel_impl(std::size_t capacity = Size)
+      : buffer_{capacity}, head_{0}, tail_{0}, readers_slots_(0), writer_slots_(capacity) {
   }
 
   ~channel_impl() {
     // delete queue_;
   }
 
+  /**
+   * Creates a channel with its semaphores in the same allocation
+   */
+  static std::shared_ptr<channel_impl> create(std::size_t capacity = Size) {
+    auto impl = std::make_shared<channel_impl>(capacity);
+    impl->readers_slots_.set_owner(impl);
+    impl->writer_slots_.set_owner(impl);
+    return impl;
+  }
+
   inline void close() {
     writer_slots_.disable();
     if (head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire) == 0)
       readers_slots_.disable();
   }
 
-  void consume_write(thread_id, ContentType value) {
+  bool consume_write(thread_id, ContentType value) {
     size_t head = head_.fetch_add(1, std::memory_order_acq_rel);
-    buffer_[head % Size] = std::move(value);
+    buffer_[head] = std::move(value);
     readers_slots_.post();
+    return true;
   }
 
   void consume_read(thread_id, ContentType& value) {
     size_t tail = tail_.fetch_add(1, std::memory_order_acq_rel);
-    value = std::move(buffer_[tail % Size]);
+    value = std::move(buffer_[tail]);
     auto rc = writer_slots_.post();
     if (!rc) { // Channel has been closed !
       if (head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire) == 0) // All elements are consumed
@@ -74,7 +151,11 @@ class channel_impl {
   /**
    * Write an element in the channel
    *
-   * Returns false only if the channel is closed.
+   * Returns false only if the channel is closed. Without any waiter, it
+   * costs three atomic read-modify-writes : the ticket taken from
+   * writer_slots_, the head_ increment, and the readers_slots_ post which
+   * learns from its increment that no waiter has to be woken up. Reads cost
+   * the same on the other side.
    */
   channel_result write(thread_id tid, ContentType value, int timeout_ms = -1) {
     auto ticket = writer_slots_.wait(timeout_ms);
@@ -95,6 +176,53 @@ class channel_impl {
     consume_read(tid, value);
     return { channel_result_value::ok };
   }
+
+  /**
+   * Writes up to count elements, moved from values
+   *
+   * Only waits for the first slot, count is set to the number of elements
+   * written.
+   */
+  channel_result write_n(thread_id, ContentType* values, std::size_t& count,
+                         int timeout_ms = -1) {
+    if (0 == count) return {channel_result_value::ok};
+    auto ticket = writer_slots_.wait(timeout_ms);
+    if (!ticket) {
+      count = 0;
+      return internal::failed_channel_op(ticket);
+    }
+    count = 1 + writer_slots_.try_wait(internal::ticket_count(count - 1));
+    size_t head = head_.fetch_add(count, std::memory_order_acq_rel);
+    for (std::size_t index = 0; index < count; ++index)
+      buffer_[head + index] = std::move(values[index]);
+    readers_slots_.post(static_cast<int>(count));
+    return {channel_result_value::ok};
+  }
+
+  /**
+   * Reads up to count elements
+   *
+   * Only waits for the first element, count is set to the number of elements
+   * read.
+   */
+  channel_result read_n(thread_id, ContentType* values, std::size_t& count, int timeout_ms = -1) {
+    if (0 == count) return {channel_result_value::ok};
+    auto ticket = readers_slots_.wait(timeout_ms);
+    if (!ticket) {
+      count = 0;
+      return internal::failed_channel_op(ticket);
+    }
+    count = 1 + readers_slots_.try_wait(internal::ticket_count(count - 1));
+    size_t tail = tail_.fetch_add(count, std::memory_order_acq_rel);
+    for (std::size_t index = 0; index < count; ++index)
+      values[index] = std::move(buffer_[tail + index]);
+    auto rc = writer_slots_.post(static_cast<int>(count));
+    if (!rc) {  // Channel has been closed !
+      if (head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire) == 0)
+        readers_slots_.disable();
+    }
+    return {channel_result_value::ok};
+  }
 };
 
 /**
@@ -102,7 +230,6 @@ class channel_impl {
  */
 template <std::size_t Size>
 class channel_impl<std::nullptr_t,Size> {
-  static_assert(0 < Size, "Boson channels do not support zero size.");
   template <class Content, std::size_t InSize, class Func>
   friend class internal::select_impl::event_channel_read_storage;
   template <class Content, std::size_t InSize, class Func>
@@ -111,23 +238,34 @@ class channel_impl<std::nullptr_t,Size> {
   using ContentType = std::nullptr_t;
 
   // Waiting lists
-  boson::shared_semaphore readers_slots_;
-  boson::shared_semaphore writer_slots_;
+  boson::semaphore readers_slots_;
+  boson::semaphore writer_slots_;
 
  public:
-  channel_impl() : readers_slots_(0), writer_slots_(Size) {
+  channel_impl(std::size_t capacity = Size) : readers_slots_(0), writer_slots_(capacity) {
   }
 
   ~channel_impl() {
   }
 
+  /**
+   * Creates a channel with its semaphores in the same allocation
+   */
+  static std::shared_ptr<channel_impl> create(std::size_t capacity = Size) {
+    auto impl = std::make_shared<channel_impl>(capacity);
+    impl->readers_slots_.set_owner(impl);
+    impl->writer_slots_.set_owner(impl);
+    return impl;
+  }
+
   inline void close() {
     writer_slots_.disable();
     readers_slots_.disable();
   }
 
-  void consume_write(thread_id tid, ContentType value) {
+  bool consume_write(thread_id tid, ContentType value) {
     readers_slots_.post();
+    return true;
   }
 
   void consume_read(thread_id tid, ContentType& value) {
@@ -157,6 +295,365 @@ class channel_impl<std::nullptr_t,Size> {
     consume_read(tid, value);
     return { channel_result_value::ok };
   }
+
+  channel_result write_n(thread_id, ContentType*, std::size_t& count, int timeout_ms = -1) {
+    if (0 == count) return {channel_result_value::ok};
+    auto ticket = writer_slots_.wait(timeout_ms);
+    if (!ticket) {
+      count = 0;
+      return internal::failed_channel_op(ticket);
+    }
+    count = 1 + writer_slots_.try_wait(internal::ticket_count(count - 1));
+    readers_slots_.post(static_cast<int>(count));
+    return {channel_result_value::ok};
+  }
+
+  channel_result read_n(thread_id, ContentType* values, std::size_t& count, int timeout_ms = -1) {
+    if (0 == count) return {channel_result_value::ok};
+    auto ticket = readers_slots_.wait(timeout_ms);
+    if (!ticket) {
+      count = 0;
+      return internal::failed_channel_op(ticket);
+    }
+    count = 1 + readers_slots_.try_wait(internal::ticket_count(count - 1));
+    std::fill(values, values + count, nullptr);
+    writer_slots_.post(static_cast<int>(count));
+    return {channel_result_value::ok};
+  }
+};
+
+/**
+ * Unbuffered channel, where a writer and a reader meet
+ *
+ * A value is moved from the writer straight into the reader destination.
+ * Writers take turns to offer their value, readers wait for an offer, and
+ * the writer parks until a reader took it. A write returns once a reader
+ * got the value. Routines park on the semaphores, so nothing is allocated
+ * and no lock is taken per exchange.
+ *
+ * taken_ is never disabled : a writer whose offer got claimed is always let
+ * go by the reader, once the value has been moved. Closing the channel
+ * withdraws a pending offer and lets its writer go the same way.
+ */
+template <class ContentType>
+class rendezvous_channel_impl {
+  enum offer_state : int { no_offer, offered, claimed, withdrawn };
+
+  // Written by the writer whose turn it is, read by the reader claiming it
+  ContentType* offer_ = nullptr;
+  std::atomic<int> state_{no_offer};
+
+  boson::semaphore writer_turn_{1};
+  boson::semaphore offers_{0};
+  boson::semaphore taken_{0};
+
+  // Milliseconds left before the deadline, -1 if there is none
+  static int remaining(std::chrono::high_resolution_clock::time_point deadline,
+                       int timeout_ms) {
+    using namespace std::chrono;
+    if (timeout_ms < 0) return -1;
+    auto left = duration_cast<milliseconds>(deadline - high_resolution_clock::now()).count();
+    return 0 < left ? static_cast<int>(left) : 0;
+  }
+
+ protected:
+  template <class Impl>
+  static void set_owners(std::shared_ptr<Impl> const& impl) {
+    impl->writer_turn_.set_owner(impl);
+    impl->offers_.set_owner(impl);
+    impl->taken_.set_owner(impl);
+  }
+
+ public:
+  inline void close() {
+    writer_turn_.disable();
+    offers_.disable();
+    int expected = offered;
+    if (state_.compare_exchange_strong(expected, withdrawn)) taken_.post();
+  }
+
+  channel_result write(thread_id, ContentType value, int timeout_ms = -1) {
+    using namespace std::chrono;
+    auto deadline = high_resolution_clock::now() + milliseconds(timeout_ms);
+    auto turn = writer_turn_.wait(timeout_ms);
+    if (!turn) return internal::failed_channel_op(turn);
+
+    offer_ = &value;
+    state_.store(offered, std::memory_order_release);
+    if (!offers_.post()) {
+      // Closed since our turn came, unless close saw the offer and withdrew it
+      int expected = offered;
+      if (state_.compare_exchange_strong(expected, no_offer))
+        return {channel_result_value::closed};
+    }
+    auto ticket = taken_.wait(remaining(deadline, timeout_ms));
+    if (!ticket) {
+      int expected = offered;
+      if (state_.compare_exchange_strong(expected, no_offer)) {
+        // Nobody took it, the ticket of the offer is taken back if still there
+        offers_.try_wait();
+        writer_turn_.post();
+        return internal::failed_channel_op(ticket);
+      }
+      // Claimed or withdrawn meanwhile, we are about to be let go
+      taken_.wait();
+    }
+    // Readers store no_offer once done with the value, before posting taken_
+    int state = state_.load(std::memory_order_acquire);
+    assert(state == no_offer || state == withdrawn);
+    writer_turn_.post();
+    if (state == withdrawn) {
+      state_.store(no_offer, std::memory_order_relaxed);
+      return {channel_result_value::closed};
+    }
+    return {channel_result_value::ok};
+  }
+
+  channel_result read(thread_id, ContentType& value, int timeout_ms = -1) {
+    using namespace std::chrono;
+    auto deadline = high_resolution_clock::now() + milliseconds(timeout_ms);
+    for (;;) {
+      auto ticket = offers_.wait(remaining(deadline, timeout_ms));
+      if (!ticket) return internal::failed_channel_op(ticket);
+      int expected = offered;
+      // The ticket of an offer taken back may be left to us
+      if (state_.compare_exchange_strong(expected, claimed, std::memory_order_acquire)) {
+        value = std::move(*offer_);
+        state_.store(no_offer, std::memory_order_release);
+        taken_.post();
+        return {channel_result_value::ok};
+      }
+    }
+  }
+
+  // Values are handed over one at a time
+  channel_result write_n(thread_id tid, ContentType* values, std::size_t& count,
+                         int timeout_ms = -1) {
+    if (0 == count) return {channel_result_value::ok};
+    auto result = write(tid, std::move(*values), timeout_ms);
+    count = result ? 1 : 0;
+    return result;
+  }
+
+  channel_result read_n(thread_id tid, ContentType* values, std::size_t& count,
+                        int timeout_ms = -1) {
+    if (0 == count) return {channel_result_value::ok};
+    auto result = read(tid, *values, timeout_ms);
+    count = result ? 1 : 0;
+    return result;
+  }
+};
+
+/**
+ * Specialization for unbuffered channels
+ */
+template <class ContentType>
+class channel_impl<ContentType, 0> : public rendezvous_channel_impl<ContentType> {
+ public:
+  static std::shared_ptr<channel_impl> create() {
+    auto impl = std::make_shared<channel_impl>();
+    rendezvous_channel_impl<ContentType>::set_owners(impl);
+    return impl;
+  }
+};
+
+template <>
+class channel_impl<std::nullptr_t, 0> : public rendezvous_channel_impl<std::nullptr_t> {
+ public:
+  static std::shared_ptr<channel_impl> create() {
+    auto impl = std::make_shared<channel_impl>();
+    rendezvous_channel_impl<std::nullptr_t>::set_owners(impl);
+    return impl;
+  }
+};
+
+/**
+ * Channel without capacity
+ *
+ * Values are kept in a lock free queue of linked segments growing as needed,
+ * so writes never wait. A soft limit can be given, high_water is then called
+ * by the write making the channel reach it, to let the application apply
+ * some backpressure.
+ */
+template <class ContentType>
+class unbounded_channel_impl {
+  template <class Content, std::size_t InSize, class Func>
+  friend class internal::select_impl::event_channel_read_storage;
+  template <class Content, std::size_t InSize, class Func>
+  friend class internal::select_impl::event_channel_write_storage;
+
+  // Writes only take a ticket in a select statement, and give it back
+  // right away, so it never runs out
+  static constexpr int const write_tickets = 1 << 20;
+
+  // Set in writers_ once the channel is closed
+  static constexpr std::size_t closed_flag = std::size_t{1} << (sizeof(std::size_t) * 8 - 1);
+
+  queues::segmented_queue<ContentType> queue_;
+
+  // Writes in progress, so that the last one out of a closed channel can
+  // tell readers it has been drained
+  std::atomic<std::size_t> writers_;
+
+  // Only kept up to date with a soft limit
+  std::atomic<std::size_t> size_;
+  std::size_t soft_limit_;
+  std::function<void(std::size_t)> high_water_;
+
+ protected:
+  // Waiting lists
+  boson::semaphore readers_slots_;
+  boson::semaphore writer_slots_;
+
+ private:
+  inline bool tracks_size() const {
+    return 0 < soft_limit_ && high_water_;
+  }
+
+  // Readers are told the channel is closed once nothing is left in it
+  inline void disable_readers_if_drained() {
+    if (queue_.empty()) readers_slots_.disable();
+  }
+
+  // Returns false if the channel is closed
+  inline bool enter_write() {
+    if (!(writers_.fetch_add(1) & closed_flag)) return true;
+    leave_write();
+    return false;
+  }
+
+  inline void leave_write() {
+    if (writers_.fetch_sub(1) == (closed_flag | 1)) disable_readers_if_drained();
+  }
+
+  // Calls high_water if count new values made the channel reach the limit
+  inline void grow(std::size_t count) {
+    if (!tracks_size()) return;
+    std::size_t size = size_.fetch_add(count, std::memory_order_relaxed) + count;
+    if (size - count < soft_limit_ && soft_limit_ <= size) high_water_(size);
+  }
+
+  inline void after_reads(std::size_t count) {
+    if (tracks_size()) size_.fetch_sub(count, std::memory_order_relaxed);
+    if (writers_.load() == closed_flag) disable_readers_if_drained();
+  }
+
+  // Returns false if the channel is closed
+  bool push(ContentType& value) {
+    if (!enter_write()) return false;
+    queue_.write(std::move(value));
+    readers_slots_.post();
+    leave_write();
+    grow(1);
+    return true;
+  }
+
+ public:
+  unbounded_channel_impl(std::size_t soft_limit, std::function<void(std::size_t)> high_water)
+      : writers_{0},
+        size_{0},
+        soft_limit_{soft_limit},
+        high_water_{std::move(high_water)},
+        readers_slots_(0),
+        writer_slots_(write_tickets) {
+  }
+
+  inline void close() {
+    writer_slots_.disable();
+    if (0 == (writers_.fetch_or(closed_flag) & ~closed_flag)) disable_readers_if_drained();
+  }
+
+  /**
+   * Writes a value once a select got a ticket
+   *
+   * Returns false if the channel has been closed meanwhile.
+   */
+  bool consume_write(thread_id, ContentType value) {
+    bool pushed = push(value);
+    writer_slots_.post();
+    return pushed;
+  }
+
+  void consume_read(thread_id, ContentType& value) {
+    queue_.read(value);
+    after_reads(1);
+  }
+
+  /**
+   * Write an element in the channel
+   *
+   * Returns false only if the channel is closed.
+   */
+  channel_result write(thread_id, ContentType value, int = -1) {
+    return {push(value) ? channel_result_value::ok : channel_result_value::closed};
+  }
+
+  channel_result read(thread_id tid, ContentType& value, int timeout_ms = -1) {
+    auto ticket = readers_slots_.wait(timeout_ms);
+    if (!ticket)
+      return {ticket == semaphore_return_value::timedout ? channel_result_value::timedout
+                                                         : channel_result_value::closed};
+    consume_read(tid, value);
+    return {channel_result_value::ok};
+  }
+
+  channel_result write_n(thread_id, ContentType* values, std::size_t& count, int = -1) {
+    if (!enter_write()) {
+      count = 0;
+      return {channel_result_value::closed};
+    }
+    for (std::size_t index = 0; index < count; ++index) queue_.write(std::move(values[index]));
+    readers_slots_.post(internal::ticket_count(count));
+    leave_write();
+    grow(count);
+    return {channel_result_value::ok};
+  }
+
+  channel_result read_n(thread_id, ContentType* values, std::size_t& count, int timeout_ms = -1) {
+    if (0 == count) return {channel_result_value::ok};
+    auto ticket = readers_slots_.wait(timeout_ms);
+    if (!ticket) {
+      count = 0;
+      return internal::failed_channel_op(ticket);
+    }
+    count = 1 + readers_slots_.try_wait(internal::ticket_count(count - 1));
+    for (std::size_t index = 0; index < count; ++index) queue_.read(values[index]);
+    after_reads(count);
+    return {channel_result_value::ok};
+  }
+};
+
+/**
+ * Specialization for unbounded channels
+ */
+template <class ContentType>
+class channel_impl<ContentType, unbounded_channel_size>
+    : public unbounded_channel_impl<ContentType> {
+ public:
+  using unbounded_channel_impl<ContentType>::unbounded_channel_impl;
+
+  static std::shared_ptr<channel_impl> create(
+      std::size_t soft_limit = 0, std::function<void(std::size_t)> high_water = {}) {
+    auto impl = std::make_shared<channel_impl>(soft_limit, std::move(high_water));
+    impl->readers_slots_.set_owner(impl);
+    impl->writer_slots_.set_owner(impl);
+    return impl;
+  }
+};
+
+template <>
+class channel_impl<std::nullptr_t, unbounded_channel_size>
+    : public unbounded_channel_impl<std::nullptr_t> {
+ public:
+  using unbounded_channel_impl<std::nullptr_t>::unbounded_channel_impl;
+
+  static std::shared_ptr<channel_impl> create(
+      std::size_t soft_limit = 0, std::function<void(std::size_t)> high_water = {}) {
+    auto impl = std::make_shared<channel_impl>(soft_limit, std::move(high_water));
+    impl->readers_slots_.set_owner(impl);
+    impl->writer_slots_.set_owner(impl);
+    return impl;
+  }
 };
 
 /**
@@ -167,7 +664,7 @@ class channel_impl<std::nullptr_t,Size> {
  * never be transmitted to new routines through reference
  * but only by copy.
  */
-template <class ContentType, std::size_t Size>
+template <class ContentType, std::size_t Size = dynamic_channel_size>
 class channel {
   template <class Content, std::size_t InSize, class Func>
   friend class internal::select_impl::event_channel_read_storage;
@@ -195,10 +692,22 @@ class channel {
   /**
    * Channel construction determines its behavior
    *
-   * == 0 means sync channel
+   * == 0 means unbuffered channel, a write waits for a reader
    * > 0 means channel of size capacity
+   *
+   * With dynamic_channel_size, the capacity is given at construction. With
+   * unbounded_channel_size, an optional soft limit and high water callback
+   * can be given.
    */
-  channel() : channel_{new impl_t} {
+  channel() : channel_{impl_t::create()} {
+    static_assert(Size != dynamic_channel_size, "The channel capacity must be given.");
+  }
+  explicit channel(std::size_t capacity) : channel_{impl_t::create(capacity)} {
+    static_assert(Size == dynamic_channel_size || Size == unbounded_channel_size,
+                  "The channel capacity is already given by its type.");
+  }
+  channel(std::size_t soft_limit, std::function<void(std::size_t)> high_water)
+      : channel_{impl_t::create(soft_limit, std::move(high_water))} {
   }
   channel(channel const&) = default;
   channel(channel&&) = default;
@@ -213,8 +722,13 @@ class channel {
     channel_->close();
   }
 
-  inline void consume_write(ContentType value) {
-    channel_->consume_write(get_id(), std::move(value));
+  /**
+   * Writes a value once a select got a ticket
+   *
+   * Returns false if the channel has been closed meanwhile.
+   */
+  inline bool consume_write(ContentType value) {
+    return channel_->consume_write(get_id(), std::move(value));
   }
 
   inline void consume_read(ContentType& value) {
@@ -228,6 +742,25 @@ class channel {
   inline channel_result read(ContentType& value, int timeout_ms = -1) {
     return channel_->read(get_id(), value, timeout_ms);
   }
+
+  /**
+   * Writes up to count elements at once, moved from values
+   *
+   * Waits for room for the first one only. count is set to the number of
+   * elements written.
+   */
+  inline channel_result write_n(ContentType* values, std::size_t& count, int timeout_ms = -1) {
+    return channel_->write_n(get_id(), values, count, timeout_ms);
+  }
+
+  /**
+   * Reads up to count elements at once
+   *
+   * Waits for the first one only. count is set to the number of elements read.
+   */
+  inline channel_result read_n(ContentType* values, std::size_t& count, int timeout_ms = -1) {
+    return channel_->read_n(get_id(), values, count, timeout_ms);
+  }
 };
 
 template <class ContentType, std::size_t Size, class ValueType>
@@ -0,0 +1,90 @@
+#ifndef BOSON_CONDITION_VARIABLE_H_
+#define BOSON_CONDITION_VARIABLE_H_
+#include <atomic>
+#include "mutex.h"
+
+namespace boson {
+
+namespace internal {
+namespace select_impl {
+template <class>
+class event_condition_wait_storage;
+}
+
+/**
+ * State shared by every copy of a condition_variable
+ *
+ * Notifications are tickets of the semaphore. Waiters are counted before
+ * they unlock the mutex, so that a notification is not missed by a routine
+ * about to wait, and only the tickets missing for them are posted.
+ */
+struct condition_variable_state {
+  std::atomic<int> nb_waiting_;
+  semaphore notifications_;
+
+  inline condition_variable_state();
+};
+
+condition_variable_state::condition_variable_state() : nb_waiting_{0}, notifications_{0} {
+}
+
+}  // namespace internal
+
+/**
+ * Condition variable for routines, used with a boson::mutex
+ *
+ * Wake ups may be spurious, the condition must be checked again, as with
+ * any condition variable.
+ */
+class condition_variable {
+  template <class>
+  friend class internal::select_impl::event_condition_wait_storage;
+  std::shared_ptr<internal::condition_variable_state> impl_;
+
+  // Tickets to post to wake up at most count waiters
+  int missing_tickets(int count) const;
+
+ public:
+  condition_variable();
+  condition_variable(condition_variable const&) = default;
+  condition_variable(condition_variable&&) = default;
+  condition_variable& operator=(condition_variable const&) = default;
+  condition_variable& operator=(condition_variable&&) = default;
+  ~condition_variable() = default;
+
+  /**
+   * Unlocks the mutex, waits for a notification and locks it back
+   *
+   * The mutex is locked back even on timeout.
+   */
+  semaphore_result wait(mutex& mut, int timeout = -1);
+  inline semaphore_result wait(mutex& mut, std::chrono::milliseconds timeout);
+
+  /**
+   * Waits until the predicate is true
+   */
+  template <class Predicate>
+  void wait(mutex& mut, Predicate predicate);
+
+  void notify_one();
+
+  /**
+   * Wakes up every waiting routine, in a single post
+   */
+  void notify_all();
+};
+
+// inline implementations
+
+semaphore_result condition_variable::wait(mutex& mut, std::chrono::milliseconds timeout) {
+  return wait(mut, static_cast<int>(timeout.count()));
+}
+
+template <class Predicate>
+void condition_variable::wait(mutex& mut, Predicate predicate) {
+  while (!predicate()) wait(mut, -1);
+}
+
+}  // namespace boson
+
+#endif  // BOSON_CONDITION_VARIABLE_H_
@@ -47,7 +47,7 @@ class engine : public internal::net_event_handler<uint64_t> {
   using command_new_routine_data = std::tuple<thread_id, std::unique_ptr<internal::routine>>;
   using command_data = json_backbone::variant<std::nullptr_t, int, size_t, command_new_routine_data>;
 
-  struct command {
+  struct command : memory::slab_allocated {
     thread_id from;
     command_type type;
     command_data data;
@@ -84,7 +84,8 @@ class engine : public internal::net_event_handler<uint64_t> {
   thread_id register_thread_id();
 
   //using queue_t = queues::lcrq;
-  using queue_t = queues::mpsc<std::unique_ptr<command>>;
+  using queue_t =
+      queues::mpsc<std::unique_ptr<command>, memory::slab_allocator<std::unique_ptr<command>>>;
   queue_t command_queue_;
   std::condition_variable command_waiter_;
   internal::netpoller<uint64_t> event_loop_;
@@ -18,6 +18,7 @@ struct netpoller_platform_impl {
   netpoller_platform_impl(io_event_handler& handler);
   ~netpoller_platform_impl();
   void register_fd(fd_t fd);
+  void register_listening_fd(fd_t fd, bool exclusive);
   void unregister(fd_t fd);
   io_loop_end_reason wait(int timeout_ms);
   void interrupt();
@@ -126,6 +127,23 @@ class netpoller : public io_event_handler, private netpoller_platform_impl {
     waiters_[fd].registered = true;
   }
 
+  /**
+   * Tells the net poller a listening socket should be watched
+   *
+   * A listening socket may be watched by several netpollers at once. With
+   * exclusive set, the kernel wakes only one of them per event. Does nothing
+   * if the fd is already watched.
+   *
+   * Can be called from any thread
+   */
+  void signal_new_listening_fd(fd_t fd, bool exclusive) {
+    std::lock_guard<std::mutex> guard(waiters_[fd].lock);
+    if (!waiters_[fd].registered) {
+      netpoller_platform_impl::register_listening_fd(fd, exclusive);
+      waiters_[fd].registered = true;
+    }
+  }
+
   /**
    * Tells the netpoller the fd will not produce events anymore
    *
@@ -9,6 +9,7 @@
 #include "boson/syscalls.h"
 #include "boson/utility.h"
 #include "boson/memory/local_ptr.h"
+#include "boson/memory/slab_allocator.h"
 #include "fcontext.h"
 #include "stack.h"
 #include "../event_loop.h"
@@ -22,11 +23,13 @@ class base_wfqueue;
 
 using routine_id = std::size_t;
 class semaphore;
+class local_semaphore;
 
 namespace internal {
 class routine;
 class thread;
 class timed_routines_set;
+struct routine_slot;
 }
 
 using routine_ptr_t = std::unique_ptr<internal::routine>;
@@ -48,6 +51,7 @@ enum class routine_status {
   yielding,              // Routine yielded and waits to be resumed
   wait_events,           // Routine awaits some events
   sema_event_candidate,  // Special status to use the routine as a scheduled one
+  migrating,             // Routine waits to be handed over to another thread
   finished               // Routine finished execution
 };
 
@@ -60,7 +64,8 @@ enum class event_type {
   io_read,
   io_write,
   sema_wait,
-  sema_closed
+  sema_closed,
+  local_wait  // Woken up directly by a routine of the same thread
   //io_read_panic,
   //io_write_panic
 };
@@ -104,6 +109,10 @@ template <>
 struct is_small_type<boson::internal::routine_io_event> {
   constexpr static bool const value = true;
 };
+template <>
+struct is_small_type<boson::internal::routine_sema_event_data> {
+  constexpr static bool const value = true;
+};
 }
 
 namespace boson {
@@ -153,13 +162,51 @@ class function_holder_impl : public function_holder {
   }
 };
 
+/**
+ * Creates the holder of a routine function
+ *
+ * Holders are shared so that joinable routines can hand their result over
+ * to their handles, within the same allocation.
+ */
 template <class Function, class... Args>
-decltype(auto) make_unique_function_holder(Function&& func, Args&&... args) {
-  return std::unique_ptr<function_holder>(new function_holder_impl<std::decay_t<Function>, Args...>(
-      std::forward<Function>(func), std::forward<Args>(args)...));
+decltype(auto) make_shared_function_holder(Function&& func, Args&&... args) {
+  return std::shared_ptr<function_holder>(
+      std::allocate_shared<function_holder_impl<std::decay_t<Function>, Args...>>(
+          memory::slab_allocator<function_holder_impl<std::decay_t<Function>, Args...>>{},
+          std::forward<Function>(func), std::forward<Args>(args)...));
 }
 }  // namespace detail
 
+/**
+ * Storage of a routine_local in a routine
+ */
+struct routine_local_slot {
+  void* value = nullptr;
+  void (*destroy)(void*) = nullptr;
+  std::size_t generation = 0;
+};
+
+/**
+ * Key of a routine_local
+ *
+ * Indexes are given again once their routine_local is destroyed, the
+ * generation tells apart the values left by a previous owner of the index.
+ */
+struct routine_local_key {
+  std::size_t index;
+  std::size_t generation;
+};
+
+/**
+ * Gives a new key to a routine_local
+ */
+routine_local_key new_routine_local_key();
+
+/**
+ * Gives back the key of a destroyed routine_local
+ */
+void free_routine_local_key(routine_local_key key);
+
 struct in_context_function {
   virtual ~in_context_function() = default;
   virtual void operator()(thread* this_thread) = 0;
@@ -174,22 +221,24 @@ struct queue_request {
  * routine represents a single unit of execution
  *
  */
-class routine {
+class routine : public memory::slab_allocated {
   friend void detail::resume_routine(transfer_t);
   friend void boson::yield();
+  friend void boson::migrate_to(std::size_t);
   friend void boson::usleep(std::chrono::microseconds);
   template <bool,bool> friend int boson::wait_readiness(fd_t,int);
   template <class ContentType>
   friend class channel;
   friend class thread;
   friend class boson::semaphore;
+  friend class boson::local_semaphore;
 
   struct waited_event {
     event_type type;
     routine_waiting_data data;
   };
 
-  std::unique_ptr<detail::function_holder> func_;
+  std::shared_ptr<detail::function_holder> func_;
   stack_context stack_ = allocate<default_stack_traits>();
   routine_status previous_status_ = routine_status::is_new;
   routine_status status_ = routine_status::is_new;
@@ -202,15 +251,27 @@ class routine {
   event_type happened_type_ = event_type::none;
   event_status happened_rc_ = 0;
   size_t happened_index_ = 0;
+  // Candidacies scheduled and not executed yet, when waiting for several semaphores
+  size_t nb_pending_candidacies_ = 0;
+  // Thread to hand the routine over to, when migrating
+  size_t migration_target_ = 0;
+  // Values of routine_local objects, indexed by their keys
+  std::vector<routine_local_slot> locals_;
+
+  // Destroys values of routine_local objects
+  void clear_locals();
 
  public:
   template <class Function, class... Args>
   routine(routine_id id, Function&& func, Args&&... args)
-      : func_{detail::make_unique_function_holder(std::forward<Function>(func),
+      : func_{detail::make_shared_function_holder(std::forward<Function>(func),
                                                   std::forward<Args>(args)...)},
         id_{id} {
   }
 
+  // Preferred to the template when given an already built holder
+  inline routine(routine_id id, std::shared_ptr<detail::function_holder> func);
+
   routine(routine const&) = delete;
   routine(routine&&) = default;
   routine& operator=(routine const&) = delete;
@@ -241,6 +302,10 @@ class routine {
 
   void add_write(int fd);
 
+  // Add a wait ended by a routine of the same thread, calling event_happened
+  // on the returned slot
+  routine_slot add_local_wait();
+
   // Effectively commits the event set and suspends the routine
   size_t commit_event_round();
 
@@ -277,6 +342,11 @@ class routine {
    */
   inline event_type happened_type() const;
 
+  /**
+   * Returns the slot of a routine_local, created empty if needed
+   */
+  inline routine_local_slot& local_slot(routine_local_key key);
+
   /**
    * Get the offset in the stack of the given pointer
    */
@@ -284,6 +354,10 @@ class routine {
 };
 
 // Inline implementations
+routine::routine(routine_id id, std::shared_ptr<detail::function_holder> func)
+    : func_{std::move(func)}, id_{id} {
+}
+
 routine_id routine::id() const {
   return id_;
 }
@@ -296,6 +370,17 @@ routine_status routine::status() const {
   return status_;
 }
 
+routine_local_slot& routine::local_slot(routine_local_key key) {
+  if (locals_.size() <= key.index) locals_.resize(key.index + 1);
+  if (locals_[key.index].generation != key.generation) {
+    // Left by a destroyed routine_local, its destructor may use other slots
+    routine_local_slot stale = locals_[key.index];
+    locals_[key.index] = routine_local_slot{nullptr, nullptr, key.generation};
+    if (stale.value) stale.destroy(stale.value);
+  }
+  return locals_[key.index];
+}
+
 size_t routine::happened_index() const {
     return happened_index_;
 }
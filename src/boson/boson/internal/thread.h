@@ -13,6 +13,7 @@
 #include <condition_variable>
 #include "boson/event_loop.h"
 #include "boson/memory/local_ptr.h"
+#include "boson/memory/slab_allocator.h"
 #include "boson/memory/sparse_vector.h"
 #include "boson/queues/mpsc.h"
 #include "boson/queues/simple.h"
@@ -22,11 +23,23 @@
 #include "routine.h"
 #include "../external/json_backbone.hpp"
 
+namespace boson {
+class semaphore;
+}
+
 namespace json_backbone {
 template <>
 struct is_small_type<std::unique_ptr<boson::internal::routine>> {
   constexpr static bool const value = true;
 };
+template <>
+struct is_small_type<std::pair<std::weak_ptr<boson::semaphore>, std::size_t>> {
+  constexpr static bool const value = true;
+};
+template <>
+struct is_small_type<std::tuple<std::size_t, int, boson::event_status, bool>> {
+  constexpr static bool const value = true;
+};
 }
 
 namespace boson {
@@ -53,7 +66,7 @@ using thread_command_data =
                            std::pair<std::weak_ptr<semaphore>, std::size_t>, thread_fd_event>;
 //using thread_command_data = json_backbone::variant<std::nullptr_t, int, routine_ptr_t, std::pair<semaphore*, routine*>>;
 
-struct thread_command {
+struct thread_command : memory::slab_allocated {
   thread_command_type type;
   thread_command_data data;
   inline thread_command(thread_command_type new_type, thread_command_data new_data)
@@ -93,7 +106,7 @@ class engine_proxy final {
 // Holds pointers to routines waiting for a time out
 struct timed_routines_set final {
   std::size_t nb_active = 0;
-  std::deque<std::size_t> slots;
+  std::deque<std::size_t, memory::slab_allocator<std::size_t>> slots;
 };
 
 struct routine_slot {
@@ -108,6 +121,7 @@ struct routine_slot {
 class thread : public internal::net_event_handler<uint64_t> {
   friend void detail::resume_routine(transfer_t);
   friend void boson::yield();
+  friend void boson::migrate_to(std::size_t);
   friend void boson::usleep(std::chrono::microseconds);
   template <bool, bool>
   friend int boson::wait_readiness(fd_t, int);
@@ -125,12 +139,16 @@ class thread : public internal::net_event_handler<uint64_t> {
   friend class routine;
 
   friend class boson::semaphore;
-  using engine_queue_t = queues::mpsc<std::unique_ptr<thread_command>>;
+  friend class boson::local_semaphore;
+  using engine_queue_t = queues::mpsc<std::unique_ptr<thread_command>,
+                                      memory::slab_allocator<std::unique_ptr<thread_command>>>;
   //using engine_queue_t = queues::simple_queue<std::unique_ptr<thread_command>>;
   //using engine_queue_t = queues::vectorized_queue<std::unique_ptr<thread_command>>; // NOT THREAD SAFE !!
 
   engine_proxy engine_proxy_;
-  std::deque<routine_slot> scheduled_routines_;
+  std::deque<routine_slot, memory::slab_allocator<routine_slot>> scheduled_routines_;
+  // Routines yielding while executing scheduled ones, swapped with them afterwards
+  std::deque<routine_slot, memory::slab_allocator<routine_slot>> next_scheduled_routines_;
   thread_status status_{thread_status::idle};
 
   /**
@@ -164,7 +182,9 @@ class thread : public internal::net_event_handler<uint64_t> {
    * The idea here is to avoid additional fd creation just for timers, so we can create
    * a whole lot of them without consuming the fd limit per process
    */
-  std::map<routine_time_point, timed_routines_set> timed_routines_;
+  std::map<routine_time_point, timed_routines_set, std::less<routine_time_point>,
+           memory::slab_allocator<std::pair<routine_time_point const, timed_routines_set>>>
+      timed_routines_;
 
   /**
    * Stores the number of suspended routines
@@ -193,7 +213,9 @@ class thread : public internal::net_event_handler<uint64_t> {
   };
 
   // Instances of the shared buffer
-  std::map<std::size_t, shared_buffer_storage> shared_buffers_;
+  std::map<std::size_t, shared_buffer_storage, std::less<std::size_t>,
+           memory::slab_allocator<std::pair<std::size_t const, shared_buffer_storage>>>
+      shared_buffers_;
 
   /**
    * React to a request from the main scheduler
@@ -226,6 +248,16 @@ class thread : public internal::net_event_handler<uint64_t> {
   //
   int register_write(int fd, routine_slot slot);
 
+  /**
+   * Wakes up a routine of this thread waiting for a semaphore ticket
+   *
+   * This skips the command round trip when the semaphore is posted from the
+   * thread of the waiter. Returns false if the routine is not suspended yet,
+   * because it is still subscribing to its events : the wake up must then be
+   * deferred with a command.
+   */
+  bool wake_up_semaphore_waiter(semaphore* sema, std::size_t slot_index);
+
   /**
    * Unregisters the given slot
    *
@@ -296,6 +328,31 @@ class thread : public internal::net_event_handler<uint64_t> {
                                         std::forward<Function>(func), std::forward<Args>(args)...));
     }
 
+    /**
+     * Starts a new routine in this very thread
+     *
+     * The routine is directly scheduled locally, without going through
+     * the engine command queue. This can only be called from the thread
+     * itself, typically by one of its routines.
+     */
+    template <class Function, class... Args>
+    void start_routine_local(Function && func, Args && ... args) {
+      schedule_routine(routine_slot{
+          routine_local_ptr_t(std::make_unique<routine>(engine_proxy_.get_new_routine_id(),
+                                                        std::forward<Function>(func),
+                                                        std::forward<Args>(args)...)),
+          0});
+    }
+
+    /**
+     * Watches a listening socket, possibly shared with other threads
+     *
+     * With exclusive set, only one of the threads watching the socket is
+     * woken up per incoming connection. Must be called before any wait on
+     * the socket in this thread.
+     */
+    void watch_listening_fd(fd_t fd, bool exclusive);
+
     /**
      * Returns the currently running routine
      */
@@ -351,6 +408,19 @@ void start_explicit(thread_id id, Function&& func, Args&&... args) {
                                             std::forward<Args>(args)...);
 }
 
+/**
+ * Starts a routine in the current thread
+ *
+ * Contrary to start(), the routine does not go through the engine and stays
+ * in the calling thread. Useful for connection handlers which benefit from
+ * staying on the thread where the connection has been accepted.
+ */
+template <class Function, class... Args>
+void start_local(Function&& func, Args&&... args) {
+  internal::current_thread()->start_routine_local(std::forward<Function>(func),
+                                                  std::forward<Args>(args)...);
+}
+
 template <class Function, class... Args>
 void start(Function&& func, Args&&... args) {
   internal::current_thread()->start_routine(std::forward<Function>(func),
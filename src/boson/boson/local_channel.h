@@ -0,0 +1,128 @@
+#ifndef BOSON_LOCAL_CHANNEL_H_
+#define BOSON_LOCAL_CHANNEL_H_
+
+#include "channel.h"
+#include "local_semaphore.h"
+
+namespace boson {
+
+/**
+ * Channel between routines of a single thread
+ *
+ * The local channel has the same interface as the channel, without any
+ * atomic, lock or thread command. Waiting routines are woken up directly in
+ * the thread run queue.
+ *
+ * Every routine using a local channel must run on the same thread. This
+ * is checked in debug builds. As for channels, local channels must be
+ * given to routines by copy.
+ */
+template <class ContentType, std::size_t Size = dynamic_channel_size>
+class local_channel {
+  static_assert(0 < Size && Size != unbounded_channel_size,
+                "Local channels must have a capacity.");
+
+  struct impl {
+    int nb_references;
+    internal::channel_ring<ContentType, Size> buffer;
+    std::size_t head;
+    std::size_t tail;
+    local_semaphore readers_slots;
+    local_semaphore writer_slots;
+
+    impl(std::size_t capacity)
+        : nb_references{1},
+          buffer{capacity},
+          head{0},
+          tail{0},
+          readers_slots(0),
+          writer_slots(capacity) {
+    }
+  };
+
+  impl* impl_;
+
+  void release() {
+    if (impl_ && 0 == --impl_->nb_references) delete impl_;
+  }
+
+ public:
+  using value_type = ContentType;
+
+  local_channel() : impl_{new impl(Size)} {
+    static_assert(Size != dynamic_channel_size, "The channel capacity must be given.");
+  }
+
+  explicit local_channel(std::size_t capacity) : impl_{new impl(capacity)} {
+  }
+
+  local_channel(local_channel const& other) : impl_{other.impl_} {
+    // A moved from channel has nothing to share
+    if (impl_) ++impl_->nb_references;
+  }
+
+  local_channel(local_channel&& other) : impl_{other.impl_} {
+    other.impl_ = nullptr;
+  }
+
+  local_channel& operator=(local_channel const& other) {
+    if (other.impl_) ++other.impl_->nb_references;
+    release();
+    impl_ = other.impl_;
+    return *this;
+  }
+
+  local_channel& operator=(local_channel&& other) {
+    std::swap(impl_, other.impl_);
+    return *this;
+  }
+
+  ~local_channel() {
+    release();
+  }
+
+  inline void close() {
+    impl_->writer_slots.disable();
+    if (impl_->head == impl_->tail) impl_->readers_slots.disable();
+  }
+
+  /**
+   * Write an element in the channel
+   *
+   * Returns false only if the channel is closed.
+   */
+  channel_result write(ContentType value, int timeout_ms = -1) {
+    auto ticket = impl_->writer_slots.wait(timeout_ms);
+    if (!ticket) return internal::failed_channel_op(ticket);
+    impl_->buffer[impl_->head++] = std::move(value);
+    impl_->readers_slots.post();
+    return {channel_result_value::ok};
+  }
+
+  channel_result read(ContentType& value, int timeout_ms = -1) {
+    auto ticket = impl_->readers_slots.wait(timeout_ms);
+    if (!ticket) return internal::failed_channel_op(ticket);
+    value = std::move(impl_->buffer[impl_->tail++]);
+    if (!impl_->writer_slots.post() && impl_->head == impl_->tail) {
+      // Closed, and all elements are consumed
+      impl_->readers_slots.disable();
+    }
+    return {channel_result_value::ok};
+  }
+};
+
+template <class ContentType, std::size_t Size, class ValueType>
+inline auto operator<<(local_channel<ContentType, Size>& channel, ValueType&& value) ->
+    typename std::enable_if<std::is_convertible<ValueType, ContentType>::value,
+                            channel_result>::type {
+  return channel.write(static_cast<ContentType>(std::forward<ValueType>(value)));
+}
+
+template <class ContentType, std::size_t Size>
+inline channel_result operator>>(local_channel<ContentType, Size>& channel, ContentType& value) {
+  return channel.read(value);
+}
+
+}  // namespace boson
+
+#endif  // BOSON_LOCAL_CHANNEL_H_
@@ -0,0 +1,69 @@
+#ifndef BOSON_LOCAL_SEMAPHORE_H_
+#define BOSON_LOCAL_SEMAPHORE_H_
+
+#include <chrono>
+#include <deque>
+#include "internal/routine.h"
+#include "internal/thread.h"
+#include "semaphore.h"
+
+namespace boson {
+
+/**
+ * Semaphore for routines of a single thread
+ *
+ * The local semaphore uses neither atomics nor locks. A post hands its
+ * ticket directly to the first waiter, which is put in the thread run queue
+ * without going through the engine.
+ *
+ * Every routine using it must run on the same thread, the one which used it
+ * first. This is checked in debug builds.
+ */
+class local_semaphore {
+  static constexpr int disabled_standpoint = -1;
+
+  int counter_;
+  std::deque<internal::routine_slot> waiters_;
+  internal::thread* thread_ = nullptr;
+
+  // Checks we are on the thread owning the semaphore
+  void check_thread();
+
+  // Wakes the first waiter still waiting, returns false if there is none
+  bool wake_up_a_waiter(event_status status);
+
+ public:
+  local_semaphore(int capacity);
+  local_semaphore(local_semaphore const&) = delete;
+  local_semaphore(local_semaphore&&) = default;
+  local_semaphore& operator=(local_semaphore const&) = delete;
+  local_semaphore& operator=(local_semaphore&&) = default;
+  ~local_semaphore() = default;
+
+  /**
+   * Disable the semaphore for future uses of wait
+   *
+   * Waiting routines are woken up with a failure
+   */
+  void disable();
+
+  /**
+   * Takes a ticket if it could, otherwise suspend the routine until a ticket is available
+   */
+  semaphore_result wait(int timeout_ms = -1);
+
+  inline semaphore_result wait(std::chrono::milliseconds timeout);
+
+  /**
+   * Gives back a ticket. Always non blocking
+   */
+  semaphore_result post();
+};
+
+semaphore_result local_semaphore::wait(std::chrono::milliseconds timeout) {
+  return wait(timeout.count());
+}
+
+}  // namespace boson
+
+#endif  // BOSON_LOCAL_SEMAPHORE_H_
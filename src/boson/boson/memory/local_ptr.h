@@ -1,7 +1,9 @@
 #ifndef BOSON_MEMORY_LOCAL_PTR_H_
 #define BOSON_MEMORY_LOCAL_PTR_H_
 #include <cassert>
+#include <type_traits>
 #include <utility>
+#include "slab_allocator.h"
 
 namespace boson {
 namespace memory {
@@ -14,12 +16,31 @@ namespace memory {
  *
  * The other difference is that it can invalidated the reference whenever it wants to
  * This is secure in a thread unsafe algorithm
+ *
+ * References are counted in a slab block, which also holds the value when
+ * built from one, so that creating a local_ptr costs a single allocation.
  */
 template <class T>
 class local_ptr final {
-  struct references {
+  struct references : slab_allocated {
     std::size_t shared_refs;
     T* value;
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+    inline references(T* in_value) : shared_refs{1u}, value{in_value} {
+    }
+
+    inline references(T&& in_value)
+        : shared_refs{1u}, value{new (&storage) T{std::move(in_value)}} {
+    }
+
+    inline void destroy_value() {
+      if (value == reinterpret_cast<T*>(&storage))
+        value->~T();
+      else
+        delete value;
+      value = nullptr;
+    }
   };
 
   inline void decrement() {
@@ -27,7 +48,7 @@ class local_ptr final {
       assert(0 < ref_->shared_refs);
       --ref_->shared_refs;
       if (0 == ref_->shared_refs) {
-        delete ref_->value;
+        ref_->destroy_value();
         delete ref_;
         ref_ = nullptr;
       }
@@ -38,10 +59,10 @@ class local_ptr final {
  public:
   local_ptr() : ref_{nullptr} {
   }
-  local_ptr(T* in_value) : ref_{new references{1u, in_value}} {
+  local_ptr(T* in_value) : ref_{new references{in_value}} {
   }
 
-  local_ptr(T&& in_value) : ref_{new references{1u, new T{std::move(in_value)}}} {
+  local_ptr(T&& in_value) : ref_{new references{std::move(in_value)}} {
   }
 
   local_ptr(local_ptr const& other) : ref_{other.ref_} {
@@ -81,7 +102,7 @@ class local_ptr final {
   inline void reset(T* new_value = nullptr) {
     // Assert ref ?
     if (ref_) {
-      delete ref_->value;
+      ref_->destroy_value();
       ref_->value = new_value;
     }
   }
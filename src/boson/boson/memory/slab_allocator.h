@@ -0,0 +1,100 @@
+#ifndef BOSON_MEMORY_SLAB_ALLOCATOR_H_
+#define BOSON_MEMORY_SLAB_ALLOCATOR_H_
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <type_traits>
+
+namespace boson {
+namespace memory {
+
+/**
+ * Allocates a block from the slabs of the calling thread
+ *
+ * Every thread owns a heap of size classes, up to slab_max_size bytes. A block
+ * freed by its owner goes back to its free lists, a block freed by another
+ * thread is pushed on the lock free return list of the owner, which takes them
+ * all back when one of its lists gets empty. Heaps are never released: one
+ * left by a finished thread is adopted by the next one, so blocks may outlive
+ * the thread which allocated them.
+ *
+ * Larger blocks are given to the default allocator.
+ */
+void* slab_allocate(std::size_t size);
+
+/**
+ * Gives back a block allocated by slab_allocate, from any thread
+ */
+void slab_deallocate(void* block) noexcept;
+
+/**
+ * Allocates a block aligned on alignment, a power of two
+ *
+ * Alignments larger than slab_alignment are served by a larger block, the
+ * distance to its start is stored right before the returned address.
+ */
+void* slab_allocate(std::size_t size, std::size_t alignment);
+
+/**
+ * Gives back a block allocated by slab_allocate with the same alignment
+ */
+void slab_deallocate(void* block, std::size_t alignment) noexcept;
+
+// Blocks are aligned on this, as much as the default allocator does
+static constexpr std::size_t slab_alignment = 16;
+
+// Largest size served by the slabs
+static constexpr std::size_t slab_max_size = 1024 - slab_alignment;
+
+/**
+ * Standard allocator using the slabs
+ */
+template <class T>
+class slab_allocator {
+ public:
+  using value_type = T;
+
+  slab_allocator() noexcept = default;
+
+  template <class U>
+  slab_allocator(slab_allocator<U> const&) noexcept {
+  }
+
+  T* allocate(std::size_t n) {
+    if (std::numeric_limits<std::size_t>::max() / sizeof(T) < n) throw std::bad_alloc{};
+    // Routines and their results hold user types, which may be over aligned
+    return static_cast<T*>(slab_allocate(n * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T* block, std::size_t) noexcept {
+    slab_deallocate(block, alignof(T));
+  }
+};
+
+template <class T, class U>
+inline bool operator==(slab_allocator<T> const&, slab_allocator<U> const&) noexcept {
+  return true;
+}
+
+template <class T, class U>
+inline bool operator!=(slab_allocator<T> const&, slab_allocator<U> const&) noexcept {
+  return false;
+}
+
+/**
+ * Base for classes whose instances are allocated in the slabs
+ */
+struct slab_allocated {
+  static void* operator new(std::size_t size) {
+    return slab_allocate(size);
+  }
+
+  static void operator delete(void* block) noexcept {
+    slab_deallocate(block);
+  }
+};
+
+}  // namespace memory
+}  // namespace boson
+
+#endif  // BOSON_MEMORY_SLAB_ALLOCATOR_H_
@@ -0,0 +1,22 @@
+#ifndef BOSON_NET_PROXY_H_
+#define BOSON_NET_PROXY_H_
+
+#include "boson/system.h"
+
+namespace boson {
+namespace net {
+
+/**
+ * Forwards data between two sockets until both directions are closed
+ *
+ * Data goes through kernel pipes with splice and is never copied in user
+ * space. Each direction runs in its own routine, both in the calling thread.
+ * When a side reaches end of file, the other side is shut down for writing.
+ * On error, both sockets are shut down. The sockets are not closed.
+ */
+void proxy(socket_t socket_a, socket_t socket_b);
+
+}  // namespace net
+}  // namespace boson
+
+#endif  // BOSON_NET_PROXY_H_
@@ -0,0 +1,98 @@
+#ifndef BOSON_NET_SHARDED_LISTENER_H_
+#define BOSON_NET_SHARDED_LISTENER_H_
+
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <vector>
+#include "boson/engine.h"
+#include "boson/internal/thread.h"
+#include "boson/net/socket.h"
+#include "boson/syscalls.h"
+
+namespace boson {
+namespace net {
+
+/**
+ * Policy used to spread a listener over the boson threads
+ */
+enum class listener_sharding {
+  reuse_port,       // One SO_REUSEPORT socket per thread, the kernel balances connections
+  exclusive_wakeup  // One socket watched by every thread, only one of them is woken up
+};
+
+namespace detail {
+
+// Pause before accepting again when out of resources, such as fds or memory
+static constexpr std::chrono::milliseconds accept_backoff{5};
+
+template <class Handler>
+void accept_connections(socket_t listener, bool exclusive, Handler& handler) {
+  internal::current_thread()->watch_listening_fd(listener, exclusive);
+  std::array<socket_t, 64> new_sockets;
+  for (;;) {
+    ssize_t nb_accepted = boson::accept_many(listener, new_sockets.data(), new_sockets.size());
+    if (nb_accepted < 0) {
+      // The listener has been shut down or closed, we are done
+      if (errno == EBADF || errno == EINVAL) return;
+      // Connections still wait in the backlog, retrying at once would spin
+      if (errno != ECONNABORTED && errno != EINTR) boson::sleep(accept_backoff);
+      continue;
+    }
+    // Connections are handled where they have been accepted
+    for (ssize_t index = 0; index < nb_accepted; ++index)
+      boson::start_local(handler, new_sockets[index]);
+  }
+}
+
+}  // namespace detail
+
+/**
+ * Starts one accept routine per boson thread
+ *
+ * Each thread accepts connections on its own and starts handler(socket)
+ * locally for each of them, so that no connection hops through the engine.
+ * With listener_sharding::reuse_port every thread gets its own socket bound
+ * with SO_REUSEPORT. With listener_sharding::exclusive_wakeup, a single
+ * socket is watched by every thread with EPOLLEXCLUSIVE to avoid thundering
+ * herds.
+ *
+ * Returns the listening sockets, to be given to stop_sharded_listeners.
+ */
+template <class Handler>
+std::vector<socket_t> start_sharded_listeners(
+    int port, Handler handler, listener_sharding sharding = listener_sharding::reuse_port,
+    int max_connections = 1e5) {
+  size_t nb_threads = internal::current_thread()->get_engine().max_nb_cores();
+  bool exclusive = sharding == listener_sharding::exclusive_wakeup;
+  std::vector<socket_t> listeners;
+  if (exclusive) {
+    listeners.emplace_back(create_listening_socket(port, max_connections));
+  }
+  else {
+    for (size_t index = 0; index < nb_threads; ++index)
+      listeners.emplace_back(create_sharded_listening_socket(port, max_connections));
+  }
+  for (thread_id id = 0; id < nb_threads; ++id) {
+    socket_t listener = listeners[exclusive ? 0 : id];
+    boson::start_explicit(id,
+                          [exclusive](socket_t listener, Handler handler) -> void {
+                            detail::accept_connections(listener, exclusive, handler);
+                          },
+                          listener, handler);
+  }
+  return listeners;
+}
+
+/**
+ * Stops the accept routines started by start_sharded_listeners
+ *
+ * The sockets are shut down first so that every accept routine is woken up
+ * and exits, then they are closed.
+ */
+void stop_sharded_listeners(std::vector<socket_t> const& listeners);
+
+}  // namespace net
+}  // namespace boson
+
+#endif  // BOSON_NET_SHARDED_LISTENER_H_
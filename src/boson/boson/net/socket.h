@@ -15,6 +15,36 @@ socket_t create_listening_socket(
     int non_block = true,
     in_addr_t receive_from=INADDR_ANY);
 
+/**
+ * Creates a listening socket which can share its port with others
+ *
+ * The socket is created with SO_REUSEPORT so that several of them can be
+ * bound to the same port, the kernel balancing incoming connections between
+ * them. Create one per thread to get a listener per thread.
+ */
+socket_t create_sharded_listening_socket(
+    int port,
+    int max_connections = 1e5,
+    int domain = AF_INET,
+    int type = SOCK_STREAM,
+    int protocol = 0,
+    in_addr_t receive_from=INADDR_ANY);
+
+/**
+ * Creates a bound UDP socket
+ *
+ * A positive receive_buffer_size sets SO_RCVBUF, to absorb bursts of
+ * datagrams. With reuse_port set, several sockets can be bound to the same
+ * port, the kernel spreading datagrams between them, which allows one socket
+ * per thread.
+ */
+socket_t create_udp_socket(
+    int port,
+    int receive_buffer_size = 0,
+    bool reuse_port = false,
+    int domain = AF_INET,
+    in_addr_t receive_from=INADDR_ANY);
+
 }  // namespace net
 }  // namespace boson
 
@@ -0,0 +1,247 @@
+#ifndef BOSON_NET_STREAM_H_
+#define BOSON_NET_STREAM_H_
+
+#include <cerrno>
+#include <chrono>
+#include <memory>
+#include <string>
+#include "boson/internal/routine.h"
+#include "boson/syscall_traits.h"
+#include "boson/system.h"
+#include "boson/std/experimental/chrono.h"
+
+namespace boson {
+
+namespace internal {
+namespace select_impl {
+template <class Func>
+class event_stream_read_storage;
+}
+}
+
+namespace net {
+
+/**
+ * Buffered reads and writes over a socket
+ *
+ * A stream wraps a socket with a read-ahead buffer and a write buffer, so that
+ * line or record oriented protocols do not cost a syscall per read or write.
+ *
+ * Written data is kept in the write buffer until it is full, until flush() is
+ * called, or until the stream has to wait for incoming data. Flushing before
+ * waiting means a request is always sent before waiting for its answer.
+ *
+ * Every call accepts a timeout, applied to every wait the call has to make.
+ * The stream neither closes nor flushes the socket on destruction.
+ */
+class stream {
+  template <class Func>
+  friend class internal::select_impl::event_stream_read_storage;
+
+  socket_t socket_;
+  std::unique_ptr<char[]> read_buffer_;
+  std::size_t read_capacity_;
+  std::size_t read_begin_ = 0;
+  std::size_t read_end_ = 0;
+  std::unique_ptr<char[]> write_buffer_;
+  std::size_t write_capacity_;
+  std::size_t write_size_ = 0;
+
+  ssize_t read_impl(void* buffer, std::size_t count, int timeout_ms);
+  ssize_t read_exact_impl(void* buffer, std::size_t count, int timeout_ms);
+  ssize_t read_until_impl(std::string& data, char delimiter, int timeout_ms);
+  ssize_t peek_impl(char const*& data, std::size_t count, int timeout_ms);
+  ssize_t write_impl(void const* buffer, std::size_t count, int timeout_ms);
+  ssize_t flush_impl(int timeout_ms);
+
+  // Reads once from the socket into the read buffer, flushing writes first
+  ssize_t fill(int timeout_ms);
+
+  // Copies buffered data out
+  std::size_t take(void* buffer, std::size_t count);
+
+  // Reads without ever suspending, used by select_any
+  ssize_t try_read(void* buffer, std::size_t count);
+
+ public:
+  static constexpr std::size_t const default_buffer_size = 1 << 16;
+
+  stream(socket_t socket, std::size_t read_buffer_size = default_buffer_size,
+         std::size_t write_buffer_size = default_buffer_size);
+  stream(stream const&) = delete;
+  stream(stream&&) = default;
+  stream& operator=(stream const&) = delete;
+  stream& operator=(stream&&) = default;
+  ~stream() = default;
+
+  inline socket_t socket() const;
+
+  /**
+   * Number of bytes read ahead and not consumed yet
+   */
+  inline std::size_t buffered() const;
+
+  /**
+   * Reads up to count bytes
+   *
+   * Returns the number of bytes read, 0 at end of file or -1 on error
+   */
+  ssize_t read(void* buffer, std::size_t count);
+  ssize_t read(void* buffer, std::size_t count, std::chrono::milliseconds const& timeout);
+  template <class T_Rep, class T_Period>
+  inline ssize_t read(void* buffer, std::size_t count,
+                      std::chrono::duration<T_Rep, T_Period> const& timeout) {
+    return read(buffer, count, experimental::chrono::ceil<std::chrono::milliseconds>(timeout));
+  }
+
+  /**
+   * Reads exactly count bytes
+   *
+   * Returns count, less at end of file, or -1 on error. Data is only consumed
+   * once it is all there, unless count exceeds the read buffer size.
+   */
+  ssize_t read_exact(void* buffer, std::size_t count);
+  ssize_t read_exact(void* buffer, std::size_t count, std::chrono::milliseconds const& timeout);
+  template <class T_Rep, class T_Period>
+  inline ssize_t read_exact(void* buffer, std::size_t count,
+                            std::chrono::duration<T_Rep, T_Period> const& timeout) {
+    return read_exact(buffer, count,
+                      experimental::chrono::ceil<std::chrono::milliseconds>(timeout));
+  }
+
+  /**
+   * Reads up to and including the delimiter, appending to data
+   *
+   * Returns the number of bytes appended, which does not end with the
+   * delimiter at end of file, or -1 on error.
+   */
+  ssize_t read_until(std::string& data, char delimiter);
+  ssize_t read_until(std::string& data, char delimiter,
+                     std::chrono::milliseconds const& timeout);
+  template <class T_Rep, class T_Period>
+  inline ssize_t read_until(std::string& data, char delimiter,
+                            std::chrono::duration<T_Rep, T_Period> const& timeout) {
+    return read_until(data, delimiter,
+                      experimental::chrono::ceil<std::chrono::milliseconds>(timeout));
+  }
+
+  /**
+   * Gives access to at least count buffered bytes without consuming them
+   *
+   * Less bytes are available at end of file, and count is capped by the read
+   * buffer size. Returns the number of available bytes, or -1 on error. data
+   * is valid until the next call on the stream.
+   */
+  ssize_t peek(char const*& data, std::size_t count);
+  ssize_t peek(char const*& data, std::size_t count, std::chrono::milliseconds const& timeout);
+  template <class T_Rep, class T_Period>
+  inline ssize_t peek(char const*& data, std::size_t count,
+                      std::chrono::duration<T_Rep, T_Period> const& timeout) {
+    return peek(data, count, experimental::chrono::ceil<std::chrono::milliseconds>(timeout));
+  }
+
+  /**
+   * Consumes bytes previously given by peek
+   */
+  void consume(std::size_t count);
+
+  /**
+   * Buffers data to be written
+   *
+   * When the buffer overflows, buffered and given data are written with a
+   * single writev. Returns count or -1 on error.
+   */
+  ssize_t write(void const* buffer, std::size_t count);
+  ssize_t write(void const* buffer, std::size_t count, std::chrono::milliseconds const& timeout);
+  template <class T_Rep, class T_Period>
+  inline ssize_t write(void const* buffer, std::size_t count,
+                       std::chrono::duration<T_Rep, T_Period> const& timeout) {
+    return write(buffer, count, experimental::chrono::ceil<std::chrono::milliseconds>(timeout));
+  }
+
+  /**
+   * Writes every buffered byte
+   *
+   * Returns 0 or -1 on error
+   */
+  ssize_t flush();
+  ssize_t flush(std::chrono::milliseconds const& timeout);
+  template <class T_Rep, class T_Period>
+  inline ssize_t flush(std::chrono::duration<T_Rep, T_Period> const& timeout) {
+    return flush(experimental::chrono::ceil<std::chrono::milliseconds>(timeout));
+  }
+};
+
+socket_t stream::socket() const {
+  return socket_;
+}
+
+std::size_t stream::buffered() const {
+  return read_end_ - read_begin_;
+}
+
+}  // namespace net
+
+namespace internal {
+namespace select_impl {
+
+template <class Func>
+class event_stream_read_storage {
+  net::stream& stream_;
+  void* buffer_;
+  std::size_t count_;
+  ssize_t result_;
+  Func func_;
+
+ public:
+  using func_type = Func;
+  using return_type = decltype(std::declval<Func>()(std::declval<ssize_t>()));
+
+  static return_type execute(event_stream_read_storage* self, internal::event_type,
+                             bool event_round_cancelled) {
+    if (!event_round_cancelled)
+      self->result_ = self->stream_.try_read(self->buffer_, self->count_);
+    return self->func_(self->result_);
+  }
+
+  event_stream_read_storage(net::stream& stream, void* buffer, std::size_t count, Func&& cb)
+      : stream_{stream}, buffer_{buffer}, count_{count}, result_{0}, func_{std::move(cb)} {
+  }
+
+  event_stream_read_storage(net::stream& stream, void* buffer, std::size_t count,
+                            Func const& cb)
+      : stream_{stream}, buffer_{buffer}, count_{count}, result_{0}, func_{cb} {
+  }
+
+  bool poll() {
+    result_ = stream_.try_read(buffer_, count_);
+    return !(result_ < 0 && (EAGAIN == errno || EWOULDBLOCK == errno));
+  }
+
+  bool subscribe(internal::routine* current) {
+    if (poll()) return true;
+    add_event<true>::apply(current, stream_.socket());
+    return false;
+  }
+};
+
+}  // namespace select_impl
+}  // namespace internal
+
+/**
+ * Reads from a stream in a select_any call
+ *
+ * The callback gets the same result as stream::read. Buffered writes are
+ * not flushed, they must be flushed before selecting.
+ */
+template <class Func>
+internal::select_impl::event_stream_read_storage<Func> event_read(net::stream& stream,
+                                                                  void* buffer,
+                                                                  std::size_t count,
+                                                                  Func&& cb) {
+  return {stream, buffer, count, std::forward<Func>(cb)};
+}
+
+}  // namespace boson
+
+#endif  // BOSON_NET_STREAM_H_
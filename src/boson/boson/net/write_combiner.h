@@ -0,0 +1,48 @@
+#ifndef BOSON_NET_WRITE_COMBINER_H_
+#define BOSON_NET_WRITE_COMBINER_H_
+
+#include <memory>
+#include "boson/system.h"
+
+namespace boson {
+namespace net {
+
+/**
+ * Combines writes of several routines to the same fd
+ *
+ * Writers append their buffer to a shared queue. The first of them becomes
+ * the flusher : it lets the other routines of its thread run once, so that
+ * they can append their own buffers, then writes the whole queue with a
+ * single writev. Each writer is resumed once its bytes have been written.
+ *
+ * This is the user space equivalent of corking. It is meant for many small
+ * writes to the same fd, like a broadcast to subscribers. Writes from
+ * different routines are never interleaved.
+ *
+ * write_combiner is a wrapper for a shared_ptr, it must be copied to be
+ * shared between routines.
+ */
+class write_combiner {
+  struct impl;
+  std::shared_ptr<impl> impl_;
+
+ public:
+  write_combiner(fd_t fd);
+  write_combiner(write_combiner const&) = default;
+  write_combiner(write_combiner&&) = default;
+  write_combiner& operator=(write_combiner const&) = default;
+  write_combiner& operator=(write_combiner&&) = default;
+  ~write_combiner() = default;
+
+  /**
+   * Writes the whole buffer
+   *
+   * Returns count once every byte has been written, or -1 with errno set
+   */
+  ssize_t write(void const* buffer, std::size_t count);
+};
+
+}  // namespace net
+}  // namespace boson
+
+#endif  // BOSON_NET_WRITE_COMBINER_H_
@@ -0,0 +1,59 @@
+#ifndef BOSON_NET_ZEROCOPY_H_
+#define BOSON_NET_ZEROCOPY_H_
+
+#include <chrono>
+#include <cstdint>
+#include "boson/system.h"
+#include "boson/std/experimental/chrono.h"
+
+namespace boson {
+namespace net {
+
+/**
+ * Enables MSG_ZEROCOPY sends on a socket
+ *
+ * Once enabled, boson::send(socket, buffer, length, MSG_ZEROCOPY) does not
+ * copy the buffer, which must then be left untouched until the kernel
+ * notifies the completion of the send. Returns -1 with errno set if the
+ * kernel does not support it.
+ */
+int enable_zerocopy(socket_t socket);
+
+/**
+ * Range of completed zero-copy sends
+ *
+ * The kernel numbers the MSG_ZEROCOPY sends of each socket from 0. A
+ * completion tells that the sends from first to last included are done and
+ * that their buffers can be reused. copied tells the kernel fell back on
+ * copying the data.
+ */
+struct zerocopy_completion {
+  uint32_t first;
+  uint32_t last;
+  bool copied;
+};
+
+/**
+ * Reads completion notifications from the socket error queue
+ *
+ * Suspends until at least one notification is available, then reads as many
+ * as possible up to count. The netpoller wakes the routine up when the error
+ * queue is fed. Returns the number of completions read, or -1 with errno
+ * set.
+ */
+int wait_zerocopy_completions(socket_t socket, zerocopy_completion* completions, size_t count);
+
+int wait_zerocopy_completions(socket_t socket, zerocopy_completion* completions, size_t count,
+                              std::chrono::milliseconds const& timeout);
+template <class T_Rep, class T_Period>
+inline int wait_zerocopy_completions(socket_t socket, zerocopy_completion* completions,
+                                     size_t count,
+                                     std::chrono::duration<T_Rep, T_Period> const& timeout) {
+  return wait_zerocopy_completions(socket, completions, count,
+                                   experimental::chrono::ceil<std::chrono::milliseconds>(timeout));
+}
+
+}  // namespace net
+}  // namespace boson
+
+#endif  // BOSON_NET_ZEROCOPY_H_
@@ -31,6 +31,7 @@
 
 #include <atomic>
 #include <cstring>
+#include <memory>
 #include <type_traits>
 #include <utility>
 #include "../utility.h"
@@ -38,7 +39,7 @@
 namespace boson {
 namespace queues {
 
-template <typename T>
+template <typename T, class Allocator = std::allocator<T>>
 class mpsc {
   template <class U, std::enable_if_t<!is_unique_ptr<U>{}, int> = 0>
   inline static void del(U& data) {
@@ -51,7 +52,7 @@ class mpsc {
 
  public:
   mpsc()
-      : _head(reinterpret_cast<buffer_node_t*>(new buffer_node_aligned_t)),
+      : _head(new_node()),
         _tail(_head.load(std::memory_order_relaxed)) {
     buffer_node_t* front = _head.load(std::memory_order_relaxed);
     ::memset(&front->data,0,sizeof(buffer_node_aligned_t));
@@ -63,12 +64,11 @@ class mpsc {
     while (this->read(output)) {
     }
     buffer_node_t* front = _head.load(std::memory_order_relaxed);
-    delete front;
+    delete_node(front);
   }
 
   void write(T input) {
-    buffer_node_t* node =
-        reinterpret_cast<buffer_node_t*>(new buffer_node_aligned_t);
+    buffer_node_t* node = new_node();
     new (&node->data ) T(std::move(input));
     node->next.store(nullptr,std::memory_order_relaxed);
     buffer_node_t* prev_head = _head.exchange(node, std::memory_order_acq_rel);
@@ -84,7 +84,7 @@ class mpsc {
     output = std::move(next->data);
     del(next->data);
     _tail.store(next, std::memory_order_release);
-    delete tail;
+    delete_node(tail);
     return true;
   }
 
@@ -97,6 +97,18 @@ class mpsc {
   typedef typename std::aligned_storage<
       sizeof(buffer_node_t), std::alignment_of<buffer_node_t>::value>::type buffer_node_aligned_t;
 
+  using node_allocator_t =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<buffer_node_aligned_t>;
+
+  // Nodes are written by producers and freed by the consumer
+  buffer_node_t* new_node() {
+    return reinterpret_cast<buffer_node_t*>(node_allocator_t{}.allocate(1));
+  }
+
+  void delete_node(buffer_node_t* node) {
+    node_allocator_t{}.deallocate(reinterpret_cast<buffer_node_aligned_t*>(node), 1);
+  }
+
   std::atomic<buffer_node_t*> _head;
   std::atomic<buffer_node_t*> _tail;
 };
@@ -0,0 +1,222 @@
+#ifndef BOSON_QUEUES_SEGMENTED_QUEUE_H_
+#define BOSON_QUEUES_SEGMENTED_QUEUE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace boson {
+namespace queues {
+
+/**
+ * Lock free unbounded MPMC FIFO queue, made of linked fixed-size segments
+ *
+ * Writers and readers claim a position with a CAS on their own index, then
+ * work on the slot of that position without touching the other side. A
+ * segment holds SegmentSize - 1 values : the last position of each segment
+ * is a marker telling its successor is being linked. Segments are allocated
+ * on demand, the first one by the first write, and freed by the last of
+ * their readers, so that memory follows what the queue holds.
+ *
+ * Nothing ever waits for a suspended peer : the only waits are for a thread
+ * between its claim and its next few instructions, be it a writer storing
+ * its value or linking a new segment.
+ */
+template <class Value, std::size_t SegmentSize = 32>
+class segmented_queue {
+  static_assert(2 <= SegmentSize, "Segments must hold at least a value.");
+  static constexpr std::size_t segment_capacity = SegmentSize - 1;
+
+  // Slot state bits
+  enum : unsigned { value_written = 1, value_read = 2, destroying = 4 };
+
+  struct slot {
+    typename std::aligned_storage<sizeof(Value), alignof(Value)>::type storage;
+    std::atomic<unsigned> state{0};
+
+    inline Value* value() {
+      return reinterpret_cast<Value*>(&storage);
+    }
+
+    inline void wait_written() {
+      while (!(state.load(std::memory_order_acquire) & value_written)) std::this_thread::yield();
+    }
+  };
+
+  struct segment {
+    std::atomic<segment*> next{nullptr};
+    slot slots[segment_capacity];
+
+    inline segment* wait_next() {
+      segment* next_segment = nullptr;
+      while (!(next_segment = next.load(std::memory_order_acquire))) std::this_thread::yield();
+      return next_segment;
+    }
+
+    /**
+     * Frees the segment once every reader from start on is done
+     *
+     * A reader still working on a slot is told to carry on once done.
+     */
+    static void destroy(segment* target, std::size_t start) {
+      // The last slot is read by whoever started destroying
+      for (std::size_t index = start; index + 1 < segment_capacity; ++index) {
+        slot& current = target->slots[index];
+        if (!(current.state.load(std::memory_order_acquire) & value_read) &&
+            !(current.state.fetch_or(destroying, std::memory_order_acq_rel) & value_read))
+          return;
+      }
+      delete target;
+    }
+  };
+
+  // Positions of both ends and the segments holding them
+  std::atomic<std::size_t> head_{0};
+  std::atomic<segment*> head_segment_{nullptr};
+  std::atomic<std::size_t> tail_{0};
+  std::atomic<segment*> tail_segment_{nullptr};
+
+  static inline std::size_t offset_of(std::size_t position) {
+    return position % SegmentSize;
+  }
+
+ public:
+  using value_type = Value;
+
+  segmented_queue() = default;
+  segmented_queue(segmented_queue const&) = delete;
+  segmented_queue(segmented_queue&&) = delete;
+  segmented_queue& operator=(segmented_queue const&) = delete;
+  segmented_queue& operator=(segmented_queue&&) = delete;
+
+  ~segmented_queue() {
+    std::size_t head = head_.load(std::memory_order_relaxed);
+    std::size_t tail = tail_.load(std::memory_order_relaxed);
+    segment* current = head_segment_.load(std::memory_order_relaxed);
+    for (; head != tail; ++head) {
+      if (offset_of(head) < segment_capacity) {
+        current->slots[offset_of(head)].value()->~Value();
+      }
+      else {
+        segment* next = current->next.load(std::memory_order_relaxed);
+        delete current;
+        current = next;
+      }
+    }
+    delete current;
+  }
+
+  /**
+   * Appends a value at the end of the queue
+   */
+  void write(Value value) {
+    std::size_t tail = tail_.load(std::memory_order_acquire);
+    segment* current = tail_segment_.load(std::memory_order_acquire);
+    segment* next_segment = nullptr;
+    for (;;) {
+      std::size_t offset = offset_of(tail);
+      // The writer of the last value is linking the next segment
+      if (offset == segment_capacity) {
+        std::this_thread::yield();
+        tail = tail_.load(std::memory_order_acquire);
+        current = tail_segment_.load(std::memory_order_acquire);
+        continue;
+      }
+      // Allocated ahead so that the next segment is linked right away
+      if (offset + 1 == segment_capacity && !next_segment) next_segment = new segment;
+
+      if (!current) {
+        segment* first = new segment;
+        if (tail_segment_.compare_exchange_strong(current, first, std::memory_order_release,
+                                                  std::memory_order_relaxed)) {
+          head_segment_.store(first, std::memory_order_release);
+          current = first;
+        }
+        else {
+          delete next_segment;
+          next_segment = first;
+          tail = tail_.load(std::memory_order_acquire);
+          current = tail_segment_.load(std::memory_order_acquire);
+          continue;
+        }
+      }
+
+      if (tail_.compare_exchange_weak(tail, tail + 1, std::memory_order_seq_cst,
+                                      std::memory_order_acquire)) {
+        if (offset + 1 == segment_capacity) {
+          tail_segment_.store(next_segment, std::memory_order_release);
+          tail_.store(tail + 2, std::memory_order_release);
+          current->next.store(next_segment, std::memory_order_release);
+          next_segment = nullptr;
+        }
+        slot& target = current->slots[offset];
+        new (&target.storage) Value(std::move(value));
+        target.state.fetch_or(value_written, std::memory_order_release);
+        delete next_segment;
+        return;
+      }
+      current = tail_segment_.load(std::memory_order_acquire);
+    }
+  }
+
+  /**
+   * Takes the value at the front of the queue
+   *
+   * Returns false if the queue is empty.
+   */
+  bool read(Value& value) {
+    std::size_t head = head_.load(std::memory_order_acquire);
+    segment* current = head_segment_.load(std::memory_order_acquire);
+    for (;;) {
+      std::size_t offset = offset_of(head);
+      // The reader of the last value is moving to the next segment
+      if (offset == segment_capacity) {
+        std::this_thread::yield();
+        head = head_.load(std::memory_order_acquire);
+        current = head_segment_.load(std::memory_order_acquire);
+        continue;
+      }
+      if (head == tail_.load(std::memory_order_seq_cst)) return false;
+      // The first segment is being installed by the first writer
+      if (!current) {
+        std::this_thread::yield();
+        head = head_.load(std::memory_order_acquire);
+        current = head_segment_.load(std::memory_order_acquire);
+        continue;
+      }
+
+      if (head_.compare_exchange_weak(head, head + 1, std::memory_order_seq_cst,
+                                      std::memory_order_acquire)) {
+        if (offset + 1 == segment_capacity) {
+          head_segment_.store(current->wait_next(), std::memory_order_release);
+          head_.store(head + 2, std::memory_order_release);
+        }
+        slot& target = current->slots[offset];
+        target.wait_written();
+        value = std::move(*target.value());
+        target.value()->~Value();
+        if (offset + 1 == segment_capacity)
+          segment::destroy(current, 0);
+        else if (target.state.fetch_or(value_read, std::memory_order_acq_rel) & destroying)
+          segment::destroy(current, offset + 1);
+        return true;
+      }
+      current = head_segment_.load(std::memory_order_acquire);
+    }
+  }
+
+  /**
+   * Tells if every value written has been claimed by a reader
+   */
+  bool empty() const {
+    return head_.load(std::memory_order_seq_cst) == tail_.load(std::memory_order_seq_cst);
+  }
+};
+
+}  // namespace queues
+}  // namespace boson
+
+#endif  // BOSON_QUEUES_SEGMENTED_QUEUE_H_
@@ -0,0 +1,298 @@
+#ifndef BOSON_QUEUES_WAITER_QUEUE_H_
+#define BOSON_QUEUES_WAITER_QUEUE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <utility>
+#include "../memory/slab_allocator.h"
+
+namespace boson {
+namespace queues {
+
+/**
+ * Lock free FIFO queue of waiters, with constant time cancellation
+ *
+ * A waiter is a target pointer and an index. Writing gives back a handle
+ * which cancels the waiter as long as it has not been read: cancelled
+ * waiters are tombstoned and skipped by readers, so cancelling never walks
+ * nor locks the queue.
+ *
+ * Cancelled waiters at the front of the queue are dequeued by writers and
+ * cancellers, so that a queue nobody reads does not fill up with tombstones.
+ *
+ * The queue is a Michael-Scott linked queue. Nothing is allocated before the
+ * first write, so a semaphore nobody waits on costs no allocation, and chunks
+ * come from the slabs of the thread writing first. Nodes are
+ * never given back to the allocator before the queue is destroyed, they are
+ * recycled through a free list once both the reader which dequeued them and
+ * the one which dequeued the next node are done with them. Links are node
+ * indexes tagged with a counter, which rules out the ABA problem, and
+ * handles hold a node generation, so a stale handle cannot cancel a
+ * recycled node.
+ */
+template <class Target>
+class waiter_queue {
+  using link_t = std::uint64_t;
+  static constexpr std::uint32_t null_index = std::numeric_limits<std::uint32_t>::max();
+
+  // Node state : generation, shifted, and one of these
+  enum : std::uint64_t { waiting = 0, claimed = 1, cancelled = 2, state_mask = 3 };
+
+  struct node {
+    std::atomic<link_t> next;
+    std::atomic<std::uint32_t> next_free;
+    std::atomic<int> nb_releases;
+    std::atomic<std::uint64_t> state;
+    std::atomic<Target*> target;
+    std::atomic<std::size_t> index;
+  };
+
+  // Chunk k holds first_chunk_size << k nodes
+  static constexpr std::size_t first_chunk_size = 8;
+  static constexpr std::size_t nb_chunks = 29;
+
+  std::atomic<node*> chunks_[nb_chunks];
+  std::atomic<std::uint32_t> nb_allocated_{0};
+  std::atomic<link_t> head_;
+  std::atomic<link_t> tail_;
+  std::atomic<link_t> free_{make_link(null_index, 0)};
+
+  static inline link_t make_link(std::uint32_t index, std::uint32_t tag) {
+    return static_cast<link_t>(tag) << 32 | index;
+  }
+
+  static inline std::uint32_t index_of(link_t link) {
+    return static_cast<std::uint32_t>(link);
+  }
+
+  static inline std::uint32_t tag_of(link_t link) {
+    return static_cast<std::uint32_t>(link >> 32);
+  }
+
+  node& at(std::uint32_t index) {
+    std::size_t position = index / first_chunk_size + 1;
+    std::size_t chunk = 63 - __builtin_clzll(position);
+    return chunks_[chunk].load(std::memory_order_acquire)
+        [index - first_chunk_size * ((std::size_t{1} << chunk) - 1)];
+  }
+
+  std::uint32_t allocate() {
+    // Recycled nodes first
+    link_t head = free_.load(std::memory_order_acquire);
+    while (index_of(head) != null_index) {
+      std::uint32_t next = at(index_of(head)).next_free.load(std::memory_order_relaxed);
+      if (free_.compare_exchange_weak(head, make_link(next, tag_of(head) + 1),
+                                      std::memory_order_acquire, std::memory_order_acquire))
+        return index_of(head);
+    }
+
+    // Then fresh ones, chunks are created by whoever needs them first
+    std::uint32_t index = nb_allocated_.fetch_add(1, std::memory_order_relaxed);
+    std::size_t chunk = 63 - __builtin_clzll(index / first_chunk_size + 1);
+    if (!chunks_[chunk].load(std::memory_order_acquire)) {
+      std::size_t nb_nodes = first_chunk_size << chunk;
+      node* nodes = static_cast<node*>(memory::slab_allocate(nb_nodes * sizeof(node), alignof(node)));
+      for (std::size_t position = 0; position < nb_nodes; ++position) {
+        new (&nodes[position]) node;
+        nodes[position].next.store(make_link(null_index, 0), std::memory_order_relaxed);
+        nodes[position].state.store(cancelled, std::memory_order_relaxed);
+        nodes[position].nb_releases.store(0, std::memory_order_relaxed);
+      }
+      // The first dummy is never read
+      if (0 == chunk) nodes[0].nb_releases.store(1, std::memory_order_relaxed);
+      node* expected = nullptr;
+      if (!chunks_[chunk].compare_exchange_strong(expected, nodes, std::memory_order_acq_rel))
+        memory::slab_deallocate(nodes, alignof(node));
+    }
+    return index;
+  }
+
+  /**
+   * Recycles the node once released twice
+   */
+  void release(std::uint32_t index) {
+    if (at(index).nb_releases.fetch_add(1, std::memory_order_acq_rel) != 1) return;
+    at(index).nb_releases.store(0, std::memory_order_relaxed);
+    link_t head = free_.load(std::memory_order_relaxed);
+    do {
+      at(index).next_free.store(index_of(head), std::memory_order_relaxed);
+    } while (!free_.compare_exchange_weak(head, make_link(index, tag_of(head) + 1),
+                                          std::memory_order_release,
+                                          std::memory_order_relaxed));
+  }
+
+  /**
+   * Dequeues a node, be it tombstoned or not
+   *
+   * The node must be released afterwards.
+   */
+  bool dequeue(std::uint32_t& index) {
+    if (!chunks_[0].load(std::memory_order_acquire)) return false;
+    for (;;) {
+      link_t head = head_.load(std::memory_order_acquire);
+      link_t tail = tail_.load(std::memory_order_acquire);
+      link_t next = at(index_of(head)).next.load(std::memory_order_acquire);
+      if (head != head_.load(std::memory_order_acquire)) continue;
+      if (index_of(head) == index_of(tail)) {
+        if (index_of(next) == null_index) return false;
+        // Tail is lagging behind
+        tail_.compare_exchange_weak(tail, make_link(index_of(next), tag_of(tail) + 1),
+                                    std::memory_order_release, std::memory_order_relaxed);
+      } else if (index_of(next) != null_index &&
+                 head_.compare_exchange_weak(head, make_link(index_of(next), tag_of(head) + 1),
+                                             std::memory_order_acq_rel,
+                                             std::memory_order_relaxed)) {
+        // The dequeued node is the new dummy
+        release(index_of(head));
+        index = index_of(next);
+        return true;
+      }
+    }
+  }
+
+  /**
+   * Dequeues the first node if it has been cancelled
+   *
+   * A cancelled node never changes state again, and the head comparison
+   * ensures the node checked is the one dequeued.
+   */
+  bool dequeue_cancelled() {
+    if (!chunks_[0].load(std::memory_order_acquire)) return false;
+    for (;;) {
+      link_t head = head_.load(std::memory_order_acquire);
+      link_t tail = tail_.load(std::memory_order_acquire);
+      link_t next = at(index_of(head)).next.load(std::memory_order_acquire);
+      if (head != head_.load(std::memory_order_acquire)) continue;
+      if (index_of(next) == null_index) return false;
+      if (index_of(head) == index_of(tail)) {
+        tail_.compare_exchange_weak(tail, make_link(index_of(next), tag_of(tail) + 1),
+                                    std::memory_order_release, std::memory_order_relaxed);
+        continue;
+      }
+      if ((at(index_of(next)).state.load(std::memory_order_acquire) & state_mask) != cancelled)
+        return false;
+      if (head_.compare_exchange_weak(head, make_link(index_of(next), tag_of(head) + 1),
+                                      std::memory_order_acq_rel, std::memory_order_relaxed)) {
+        // Released once as the former dummy, once as a read node
+        release(index_of(head));
+        release(index_of(next));
+        return true;
+      }
+    }
+  }
+
+  inline void skip_cancelled() {
+    while (dequeue_cancelled()) {
+    }
+  }
+
+ public:
+  using handle_t = std::uint64_t;
+  using value_type = std::pair<Target*, std::size_t>;
+
+  waiter_queue() {
+    for (auto& chunk : chunks_) chunk.store(nullptr, std::memory_order_relaxed);
+    // Node 0 is the first dummy, its chunk is allocated by the first write
+    nb_allocated_.store(1, std::memory_order_relaxed);
+    head_.store(make_link(0, 0), std::memory_order_relaxed);
+    tail_.store(make_link(0, 0), std::memory_order_relaxed);
+  }
+
+  waiter_queue(waiter_queue const&) = delete;
+  waiter_queue(waiter_queue&&) = delete;
+  waiter_queue& operator=(waiter_queue const&) = delete;
+  waiter_queue& operator=(waiter_queue&&) = delete;
+
+  ~waiter_queue() {
+    // Nodes only hold atomics, nothing to destroy
+    for (auto& chunk : chunks_) memory::slab_deallocate(chunk.load(std::memory_order_relaxed), alignof(node));
+  }
+
+  /**
+   * Enqueues a waiter and returns the handle to cancel it
+   */
+  handle_t write(Target* target, std::size_t index) {
+    skip_cancelled();
+    std::uint32_t new_index = allocate();
+    node& new_node = at(new_index);
+    new_node.target.store(target, std::memory_order_relaxed);
+    new_node.index.store(index, std::memory_order_relaxed);
+    link_t old_next = new_node.next.load(std::memory_order_relaxed);
+    new_node.next.store(make_link(null_index, tag_of(old_next) + 1), std::memory_order_relaxed);
+    std::uint64_t generation =
+        ((new_node.state.load(std::memory_order_relaxed) >> 2) + 1) & 0xffffffffu;
+    new_node.state.store(generation << 2 | waiting, std::memory_order_relaxed);
+
+    for (;;) {
+      link_t tail = tail_.load(std::memory_order_acquire);
+      node& tail_node = at(index_of(tail));
+      link_t next = tail_node.next.load(std::memory_order_acquire);
+      if (tail != tail_.load(std::memory_order_acquire)) continue;
+      if (index_of(next) == null_index) {
+        if (tail_node.next.compare_exchange_weak(next, make_link(new_index, tag_of(next) + 1),
+                                                 std::memory_order_release,
+                                                 std::memory_order_relaxed)) {
+          tail_.compare_exchange_strong(tail, make_link(new_index, tag_of(tail) + 1),
+                                        std::memory_order_release, std::memory_order_relaxed);
+          break;
+        }
+      } else {
+        tail_.compare_exchange_weak(tail, make_link(index_of(next), tag_of(tail) + 1),
+                                    std::memory_order_release, std::memory_order_relaxed);
+      }
+    }
+    return generation << 32 | new_index;
+  }
+
+  /**
+   * Dequeues the first waiter not cancelled
+   */
+  bool read(value_type& waiter) {
+    std::uint32_t index = 0;
+    while (dequeue(index)) {
+      node& read_node = at(index);
+      waiter.first = read_node.target.load(std::memory_order_relaxed);
+      waiter.second = read_node.index.load(std::memory_order_relaxed);
+      std::uint64_t state = read_node.state.load(std::memory_order_acquire);
+      bool claimed_it = false;
+      while (!claimed_it && (state & state_mask) == waiting) {
+        claimed_it = read_node.state.compare_exchange_weak(
+            state, (state & ~state_mask) | claimed, std::memory_order_acq_rel,
+            std::memory_order_acquire);
+      }
+      release(index);
+      if (claimed_it) return true;
+    }
+    return false;
+  }
+
+  /**
+   * Cancels a waiter
+   *
+   * Returns false if it has already been read, or cancelled.
+   */
+  bool cancel(handle_t handle) {
+    node& cancelled_node = at(static_cast<std::uint32_t>(handle));
+    std::uint64_t expected = (handle >> 32) << 2 | waiting;
+    if (!cancelled_node.state.compare_exchange_strong(
+            expected, (expected & ~state_mask) | cancelled, std::memory_order_acq_rel,
+            std::memory_order_relaxed))
+      return false;
+    skip_cancelled();
+    return true;
+  }
+
+  /**
+   * Number of nodes allocated so far, either queued or recycled
+   */
+  std::size_t nb_nodes() const {
+    return nb_allocated_.load(std::memory_order_relaxed);
+  }
+};
+
+}  // namespace queues
+}  // namespace boson
+
+#endif  // BOSON_QUEUES_WAITER_QUEUE_H_
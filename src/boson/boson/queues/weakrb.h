@@ -76,6 +76,20 @@ class weakrb {
     front_.store(front + 1, order_release);
     return true;
   };
+
+  /**
+   * Tells if there is nothing to read, to be called by the consumer only
+   */
+  bool empty() {
+    return back_.load(order_acquire) == front_.load(order_relaxed);
+  }
+
+  /**
+   * Tells if there is no room to write, to be called by the producer only
+   */
+  bool full() {
+    return front_.load(order_acquire) + size_ == back_.load(order_relaxed);
+  }
 };
 
 };  // namespace queues
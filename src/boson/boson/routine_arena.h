@@ -0,0 +1,125 @@
+#ifndef BOSON_ROUTINE_ARENA_H_
+#define BOSON_ROUTINE_ARENA_H_
+#include <cstddef>
+#include <cstdint>
+
+namespace boson {
+
+/**
+ * Bump allocator whose memory is released all at once
+ *
+ * Each routine has its own arena, given by current(), which is released when
+ * the routine finishes. Memory comes in chunks, which are kept by the thread
+ * releasing them for the next arenas, so that short lived routines seldom
+ * hit malloc. Deallocations do nothing, memory allocated from the arena of a
+ * routine must not be used once it finished.
+ */
+class routine_arena {
+  struct chunk_header {
+    chunk_header* next;
+  };
+
+  chunk_header* chunks_ = nullptr;
+  chunk_header* large_blocks_ = nullptr;
+  char* position_ = nullptr;
+  char* end_ = nullptr;
+  std::size_t nb_bytes_ = 0;
+
+  void* allocate_slow(std::size_t size, std::size_t alignment);
+
+ public:
+  static constexpr std::size_t chunk_size = 64 * 1024;
+
+  routine_arena() = default;
+  routine_arena(routine_arena const&) = delete;
+  routine_arena& operator=(routine_arena const&) = delete;
+  ~routine_arena();
+
+  /**
+   * Returns the arena of the running routine
+   */
+  static routine_arena& current();
+
+  /**
+   * Allocates size bytes aligned to a power of two
+   */
+  inline void* allocate(std::size_t size, std::size_t alignment = alignof(std::max_align_t));
+
+  inline void deallocate(void* pointer, std::size_t size) noexcept;
+
+  /**
+   * Releases every allocation at once
+   */
+  void release();
+
+  /**
+   * Returns the number of bytes allocated since the last release
+   */
+  inline std::size_t nb_bytes_allocated() const;
+};
+
+/**
+ * Standard allocator over a routine_arena
+ *
+ * Default constructed allocators use the arena of the running routine.
+ */
+template <class T>
+class arena_allocator {
+  template <class>
+  friend class arena_allocator;
+  routine_arena* arena_;
+
+ public:
+  using value_type = T;
+
+  arena_allocator() : arena_{&routine_arena::current()} {
+  }
+
+  explicit arena_allocator(routine_arena& arena) : arena_{&arena} {
+  }
+
+  template <class U>
+  arena_allocator(arena_allocator<U> const& other) : arena_{other.arena_} {
+  }
+
+  T* allocate(std::size_t count) {
+    return static_cast<T*>(arena_->allocate(count * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T* pointer, std::size_t count) noexcept {
+    arena_->deallocate(pointer, count * sizeof(T));
+  }
+
+  template <class U>
+  bool operator==(arena_allocator<U> const& other) const {
+    return arena_ == other.arena_;
+  }
+
+  template <class U>
+  bool operator!=(arena_allocator<U> const& other) const {
+    return arena_ != other.arena_;
+  }
+};
+
+// inline implementations
+
+void* routine_arena::allocate(std::size_t size, std::size_t alignment) {
+  auto aligned = (reinterpret_cast<std::uintptr_t>(position_) + alignment - 1) & ~(alignment - 1);
+  if (position_ && aligned + size <= reinterpret_cast<std::uintptr_t>(end_)) {
+    position_ = reinterpret_cast<char*>(aligned + size);
+    nb_bytes_ += size;
+    return reinterpret_cast<void*>(aligned);
+  }
+  return allocate_slow(size, alignment);
+}
+
+void routine_arena::deallocate(void*, std::size_t) noexcept {
+}
+
+std::size_t routine_arena::nb_bytes_allocated() const {
+  return nb_bytes_;
+}
+
+}  // namespace boson
+
+#endif  // BOSON_ROUTINE_ARENA_H_
@@ -0,0 +1,229 @@
+#ifndef BOSON_ROUTINE_HANDLE_H_
+#define BOSON_ROUTINE_HANDLE_H_
+#include <atomic>
+#include <exception>
+#include <new>
+#include <type_traits>
+#include "internal/thread.h"
+#include "memory/slab_allocator.h"
+#include "semaphore.h"
+
+namespace boson {
+
+namespace internal {
+namespace select_impl {
+template <class, class>
+class event_join_storage;
+}
+
+/**
+ * Holds the return value of a routine, if any
+ */
+template <class Result>
+class routine_result_storage {
+  typename std::aligned_storage<sizeof(Result), alignof(Result)>::type value_;
+  bool has_value_ = false;
+
+ public:
+  routine_result_storage() = default;
+  routine_result_storage(routine_result_storage const&) = delete;
+  routine_result_storage& operator=(routine_result_storage const&) = delete;
+
+  ~routine_result_storage() {
+    if (has_value_) get().~Result();
+  }
+
+  template <class Func>
+  void set_from(Func&& func) {
+    new (&value_) Result(func());
+    has_value_ = true;
+  }
+
+  Result& get() {
+    return *reinterpret_cast<Result*>(&value_);
+  }
+};
+
+template <>
+class routine_result_storage<void> {
+ public:
+  template <class Func>
+  void set_from(Func&& func) {
+    func();
+  }
+
+  void get() {
+  }
+};
+
+/**
+ * Outcome of a joinable routine, shared with its handles
+ *
+ * Joining routines suspend on done_, which never holds any ticket and is
+ * disabled once the routine returned or threw.
+ */
+template <class Result>
+class routine_result {
+  template <class, class>
+  friend class select_impl::event_join_storage;
+
+ protected:
+  routine_result_storage<Result> value_;
+  std::exception_ptr exception_;
+  std::atomic<bool> finished_{false};
+  semaphore done_{0};
+
+  void finish() {
+    finished_.store(true, std::memory_order_release);
+    done_.disable();
+  }
+
+ public:
+  bool finished() const {
+    return finished_.load(std::memory_order_acquire);
+  }
+
+  semaphore_result wait(int timeout) {
+    if (finished()) return {semaphore_return_value::ok};
+    auto result = done_.wait(timeout);
+    return {result == semaphore_return_value::timedout ? semaphore_return_value::timedout
+                                                       : semaphore_return_value::ok};
+  }
+
+  std::add_lvalue_reference_t<Result> get() {
+    if (exception_) std::rethrow_exception(exception_);
+    return value_.get();
+  }
+};
+
+namespace detail {
+
+template <class Result, class Function, class... Args>
+class joinable_function_holder_impl : public function_holder, public routine_result<Result> {
+  using ArgsTuple = typename extract_tuple_arguments<Function, Args...>::type;
+  Function func_;
+  ArgsTuple args_;
+
+ public:
+  joinable_function_holder_impl(Function&& func, Args... args)
+      : func_{std::move(func)}, args_{std::forward<Args>(args)...} {
+  }
+
+  joinable_function_holder_impl(Function const& func, Args... args)
+      : func_{func}, args_{std::forward<Args>(args)...} {
+  }
+
+  void operator()() override {
+    try {
+      this->value_.set_from(
+          [this]() -> Result { return experimental::apply(func_, std::move(args_)); });
+    } catch (...) {
+      this->exception_ = std::current_exception();
+    }
+    this->finish();
+  }
+
+  void set_owner(std::shared_ptr<joinable_function_holder_impl> const& self) {
+    this->done_.set_owner(self);
+  }
+};
+
+template <class Function, class... Args>
+using joinable_result_t =
+    std::decay_t<decltype(std::declval<std::decay_t<Function>&>()(std::declval<Args>()...))>;
+
+}  // namespace detail
+}  // namespace internal
+
+/**
+ * Handle on a routine started with start_joinable
+ *
+ * Waiting for the routine suspends the calling routine only. The result, or
+ * the exception thrown by the routine, is kept by the routine function
+ * holder, which handles share. Handles are copyable.
+ */
+template <class Result>
+class routine_handle {
+  template <class, class>
+  friend class internal::select_impl::event_join_storage;
+  std::shared_ptr<internal::routine_result<Result>> result_;
+
+ public:
+  routine_handle() = default;
+  routine_handle(std::shared_ptr<internal::routine_result<Result>> result)
+      : result_{std::move(result)} {
+  }
+
+  /**
+   * Tells if the routine returned or threw
+   */
+  bool finished() const {
+    return result_->finished();
+  }
+
+  /**
+   * Suspends until the routine returned or threw
+   */
+  semaphore_result join(int timeout = -1) {
+    return result_->wait(timeout);
+  }
+
+  semaphore_result join(std::chrono::milliseconds timeout) {
+    return result_->wait(timeout.count());
+  }
+
+  /**
+   * Joins the routine and gives its result
+   *
+   * Rethrows the exception thrown by the routine, if any.
+   */
+  std::add_lvalue_reference_t<Result> get() {
+    result_->wait(-1);
+    return result_->get();
+  }
+};
+
+namespace internal {
+namespace detail {
+template <class Function, class... Args>
+auto make_joinable_holder(Function&& func, Args&&... args) {
+  using result_type = joinable_result_t<Function, Args...>;
+  using holder_type = joinable_function_holder_impl<result_type, std::decay_t<Function>, Args...>;
+  auto holder = std::allocate_shared<holder_type>(memory::slab_allocator<holder_type>{},
+                                                  std::forward<Function>(func),
+                                                  std::forward<Args>(args)...);
+  holder->set_owner(holder);
+  return holder;
+}
+}  // namespace detail
+}  // namespace internal
+
+/**
+ * Starts a routine and gives a handle to join it and get its result
+ */
+template <class Function, class... Args>
+auto start_joinable(Function&& func, Args&&... args)
+    -> routine_handle<internal::detail::joinable_result_t<Function, Args...>> {
+  auto holder = internal::detail::make_joinable_holder(std::forward<Function>(func),
+                                                       std::forward<Args>(args)...);
+  internal::current_thread()->start_routine(
+      std::shared_ptr<internal::detail::function_holder>(holder));
+  return {std::move(holder)};
+}
+
+/**
+ * Starts a joinable routine in a specific thread
+ */
+template <class Function, class... Args>
+auto start_joinable_explicit(thread_id id, Function&& func, Args&&... args)
+    -> routine_handle<internal::detail::joinable_result_t<Function, Args...>> {
+  auto holder = internal::detail::make_joinable_holder(std::forward<Function>(func),
+                                                       std::forward<Args>(args)...);
+  internal::current_thread()->start_routine_explicit(
+      id, std::shared_ptr<internal::detail::function_holder>(holder));
+  return {std::move(holder)};
+}
+
+}  // namespace boson
+
+#endif  // BOSON_ROUTINE_HANDLE_H_
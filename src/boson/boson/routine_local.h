@@ -0,0 +1,102 @@
+#ifndef BOSON_ROUTINE_LOCAL_H_
+#define BOSON_ROUTINE_LOCAL_H_
+#include <functional>
+#include "exception.h"
+#include "internal/thread.h"
+
+namespace boson {
+
+/**
+ * Value of which each routine has its own instance
+ *
+ * This is the routine counterpart of thread_local, which must not be used
+ * from routines since they may be resumed by another thread. Each routine
+ * holds an array of slots indexed by routine_local keys, so an access is a
+ * look up in that array. Values are constructed at the first access from a
+ * routine and destroyed when it finishes, within the routine.
+ */
+template <class T>
+class routine_local {
+  internal::routine_local_key key_;
+  std::function<T*()> make_;
+
+  static void destroy(void* value) {
+    delete static_cast<T*>(value);
+  }
+
+  static internal::routine* current_routine() {
+    internal::thread* this_thread = internal::current_thread();
+    internal::routine* routine = this_thread ? this_thread->running_routine() : nullptr;
+    if (!routine) throw boson::exception("boson::routine_local used outside of a routine");
+    return routine;
+  }
+
+ public:
+  /**
+   * Values are value initialized
+   */
+  routine_local() : key_{internal::new_routine_local_key()}, make_{[]() { return new T{}; }} {
+  }
+
+  /**
+   * Values are copies of the initial one
+   */
+  explicit routine_local(T initial_value)
+      : key_{internal::new_routine_local_key()},
+        make_{[initial_value]() { return new T(initial_value); }} {
+  }
+
+  routine_local(routine_local const&) = delete;
+  routine_local& operator=(routine_local const&) = delete;
+
+  /**
+   * Values left in running routines are destroyed when they finish, or when
+   * the key is given to another routine_local
+   */
+  ~routine_local() {
+    internal::free_routine_local_key(key_);
+  }
+
+  /**
+   * Returns the value of the running routine
+   */
+  T& get() {
+    auto& slot = current_routine()->local_slot(key_);
+    if (!slot.value) {
+      slot.value = make_();
+      slot.destroy = &destroy;
+    }
+    return *static_cast<T*>(slot.value);
+  }
+
+  /**
+   * Tells if the running routine already accessed its value
+   */
+  bool has_value() const {
+    return nullptr != current_routine()->local_slot(key_).value;
+  }
+
+  /**
+   * Destroys the value of the running routine, the next access creates it again
+   */
+  void reset() {
+    auto& slot = current_routine()->local_slot(key_);
+    if (slot.value) {
+      void* value = slot.value;
+      slot.value = nullptr;
+      destroy(value);
+    }
+  }
+
+  T& operator*() {
+    return get();
+  }
+
+  T* operator->() {
+    return &get();
+  }
+};
+
+}  // namespace boson
+
+#endif  // BOSON_ROUTINE_LOCAL_H_
@@ -3,6 +3,11 @@
 #include "syscalls.h"
 #include "channel.h"
 #include "mutex.h"
+#include "shared_mutex.h"
+#include "wait_group.h"
+#include "condition_variable.h"
+#include "barrier.h"
+#include "routine_handle.h"
 #include "exception.h"
 #include "syscall_traits.h"
 #include "std/experimental/apply.h"
@@ -43,6 +48,11 @@ struct event_timer_storage
     return self->func_();
   }
 
+  bool poll() {
+    return std::get<0>(this->data_) <= std::chrono::time_point_cast<std::chrono::milliseconds>(
+                                           std::chrono::high_resolution_clock::now());
+  }
+
   bool subscribe(internal::routine* current) {
     current->add_timer(std::get<0>(this->data_));
     return false;
@@ -64,18 +74,20 @@ struct event_syscall_storage : protected event_storage<Func, std::tuple<Args...>
                : self->func_(syscall_callable<SyscallId>::apply_call(self->args_));
   }
 
-  bool subscribe(internal::routine* current) {
+  bool poll() {
     std::get<0>(this->data_) = syscall_callable<SyscallId>::apply_call(this->args_);
-    if (std::get<0>(this->data_) < 0 && (EAGAIN == errno || EWOULDBLOCK == errno)) {
-      add_event<syscall_traits<SyscallId>::is_read>::apply(current, std::get<0>(this->args_));
-      return false;
-    }
-    return true;
+    return !(std::get<0>(this->data_) < 0 && (EAGAIN == errno || EWOULDBLOCK == errno));
+  }
+
+  bool subscribe(internal::routine* current) {
+    if (poll()) return true;
+    add_event<syscall_traits<SyscallId>::is_read>::apply(current, std::get<0>(this->args_));
+    return false;
   }
 };
 
 template <class Func, class... Args>
-struct event_syscall_storage<Func, SYS_accept, Args...> : protected event_storage<Func, std::tuple<Args...>, std::tuple<int>> {
+struct event_syscall_storage<Func, SYS_accept4, Args...> : protected event_storage<Func, std::tuple<Args...>, std::tuple<int>> {
   // Reference parent type
   using parent_storage = event_storage<Func, std::tuple<Args...>, std::tuple<int>>;
   // Inherit ctors
@@ -88,18 +100,20 @@ struct event_syscall_storage<Func, SYS_accept, Args...> : protected event_storag
       return self->func_(std::get<0>(self->data_));
     }
     else {
-      fd_t new_socket = syscall_callable<SYS_accept>::apply_call(self->args_);
+      fd_t new_socket = syscall_callable<SYS_accept4>::apply_call(self->args_);
       return self->func_(new_socket);
     }
   }
 
+  bool poll() {
+    std::get<0>(this->data_) = syscall_callable<SYS_accept4>::apply_call(this->args_);
+    return !(std::get<0>(this->data_) < 0 && (EAGAIN == errno || EWOULDBLOCK == errno));
+  }
+
   bool subscribe(internal::routine* current) {
-    std::get<0>(this->data_) = syscall_callable<SYS_accept>::apply_call(this->args_);
-    if (std::get<0>(this->data_) < 0 && (EAGAIN == errno || EWOULDBLOCK == errno)) {
-      add_event<syscall_traits<SYS_accept>::is_read>::apply(current, std::get<0>(this->args_));
-      return false;
-    }
-    return true;
+    if (poll()) return true;
+    add_event<syscall_traits<SYS_accept4>::is_read>::apply(current, std::get<0>(this->args_));
+    return false;
   }
 };
 
@@ -131,10 +145,59 @@ struct event_syscall_storage<Func, SYS_connect, Args...> : protected event_stora
     return self->func_(return_code);
   }
 
+  bool poll() {
+    int& return_code{std::get<0>(this->data_)};
+    return_code = syscall_callable<SYS_connect>::apply_call(this->args_);
+    // Polled again by select_all while the connection is going on
+    if (return_code < 0 && EISCONN == errno) return_code = 0;
+    return !(return_code < 0 && (EINPROGRESS == errno || EALREADY == errno));
+  }
+
   bool subscribe(internal::routine* current) {
-    std::get<0>(this->data_) = syscall_callable<SYS_connect>::apply_call(this->args_);
-    if (std::get<0>(this->data_) < 0 && EINPROGRESS == errno) {
-      add_event<syscall_traits<SYS_connect>::is_read>::apply(current, std::get<0>(this->args_));
+    if (poll()) return true;
+    add_event<syscall_traits<SYS_connect>::is_read>::apply(current, std::get<0>(this->args_));
+    return false;
+  }
+};
+
+// Accepts several connections in a single wake up
+template <class Func>
+struct event_accept_many_storage
+    : protected event_storage<Func, std::tuple<socket_t, socket_t*, std::size_t>,
+                              std::tuple<ssize_t>> {
+  // Reference parent type
+  using parent_storage =
+      event_storage<Func, std::tuple<socket_t, socket_t*, std::size_t>, std::tuple<ssize_t>>;
+  // Inherit ctors
+  using parent_storage::parent_storage;
+  using return_type = decltype(std::declval<Func>()(std::declval<ssize_t>()));
+
+  static return_type execute(event_accept_many_storage* self, internal::event_type,
+                             bool event_round_cancelled) {
+    if (!event_round_cancelled) self->accept_pending();
+    return self->func_(std::get<0>(self->data_));
+  }
+
+  bool poll() {
+    return accept_pending() || !(EAGAIN == errno || EWOULDBLOCK == errno);
+  }
+
+  bool subscribe(internal::routine* current) {
+    if (poll()) return true;
+    add_event<syscall_traits<SYS_accept4>::is_read>::apply(current, std::get<0>(this->args_));
+    return false;
+  }
+
+ private:
+  // Returns false if nothing has been accepted
+  bool accept_pending() {
+    socket_t socket = std::get<0>(this->args_);
+    socket_t* sockets = std::get<1>(this->args_);
+    std::size_t count = std::get<2>(this->args_);
+    ssize_t& result = std::get<0>(this->data_);
+    result = 0 < count ? drain_accept_backlog(socket, sockets, count) : 0;
+    if (0 == result && 0 < count) {
+      result = -1;
       return false;
     }
     return true;
@@ -142,20 +205,55 @@ struct event_syscall_storage<Func, SYS_connect, Args...> : protected event_stora
 };
 
 class event_semaphore_wait_base_storage {
-    shared_semaphore& sema_;
+    semaphore* sema_;
+    bool disabled_ = false;
+
+ protected:
+    /**
+     * Waits on another semaphore from now on
+     *
+     * Used by events waiting on gates replaced once opened.
+     */
+    inline void rebind(semaphore& sema) {
+      sema_ = &sema;
+      disabled_ = false;
+    }
 
  public:
-    inline event_semaphore_wait_base_storage(shared_semaphore& sema) : sema_{sema} {
+    inline event_semaphore_wait_base_storage(semaphore& sema) : sema_{&sema} {
     }
 
     inline bool subscribe(internal::routine* current) {
-      int result = sema_.impl_->counter_.fetch_sub(1, std::memory_order_acquire);
+      int result = sema_->take_ticket();
+      if (semaphore::disabling_threshold < result) {
+        sema_->give_ticket_back();
+        disabled_ = true;
+        return true;
+      }
       if (result <= 0) {
-        current->add_semaphore_wait(sema_.impl_.get());
+        current->add_semaphore_wait(sema_);
         return false;
       }
       return true;
     }
+
+    /**
+     * Takes a ticket only if one is available right away
+     */
+    inline bool poll() {
+      if (semaphore::disabling_threshold < sema_->counter()) {
+        disabled_ = true;
+        return true;
+      }
+      return 0 < sema_->try_wait();
+    }
+
+    /**
+     * Tells if a ticket has been taken, either right away or after waiting
+     */
+    inline bool got_ticket(internal::event_type type, bool event_round_cancelled) const {
+      return event_round_cancelled ? !disabled_ : type == internal::event_type::sema_wait;
+    }
 };
 
 template <class Func>
@@ -171,18 +269,205 @@ class event_mutex_lock_storage : public event_semaphore_wait_base_storage {
     }
 
     event_mutex_lock_storage (mutex& mut, Func&& cb)
-        : event_semaphore_wait_base_storage{mut.impl_},
+        : event_semaphore_wait_base_storage{*mut.impl_.impl_},
           func_{std::move(cb)} {
     }
 
     event_mutex_lock_storage (mutex& mut, Func const& cb)
-        : event_semaphore_wait_base_storage{mut.impl_},
+        : event_semaphore_wait_base_storage{*mut.impl_.impl_},
+          func_{cb} {
+    }
+};
+
+template <class Func>
+class event_shared_mutex_lock_storage : public event_semaphore_wait_base_storage {
+    internal::shared_mutex_state& state_;
+    Func func_;
+    // Set when the event waits on writers_ behind a writer
+    bool behind_writers_ = false;
+
+ public:
+    using func_type = Func;
+    using return_type = decltype(std::declval<Func>()());
+
+    static return_type execute(event_shared_mutex_lock_storage* self, internal::event_type type,
+                               bool) {
+        if (self->behind_writers_) {
+          // Holding writers_, no writer holds the lock and readers_ is full
+          if (0 == self->state_.readers_.try_wait()) self->state_.readers_.wait();
+          self->state_.writers_.post();
+        }
+        return self->func_();
+    }
+
+    event_shared_mutex_lock_storage(shared_mutex& mut, Func&& cb)
+        : event_semaphore_wait_base_storage{mut.impl_->readers_},
+          state_{*mut.impl_},
+          func_{std::move(cb)} {
+    }
+
+    event_shared_mutex_lock_storage(shared_mutex& mut, Func const& cb)
+        : event_semaphore_wait_base_storage{mut.impl_->readers_},
+          state_{*mut.impl_},
+          func_{cb} {
+    }
+
+    /**
+     * Does not take a ticket right away if a writer waits
+     */
+    inline bool poll() {
+      behind_writers_ = false;
+      rebind(state_.readers_);
+      return 0 == state_.nb_writers_.load(std::memory_order_acquire) &&
+             event_semaphore_wait_base_storage::poll();
+    }
+
+    /**
+     * Waits on writers_ first if a writer waits, as lock_shared does
+     */
+    inline bool subscribe(internal::routine* current) {
+      behind_writers_ = 0 < state_.nb_writers_.load(std::memory_order_acquire);
+      rebind(behind_writers_ ? state_.writers_ : state_.readers_);
+      return event_semaphore_wait_base_storage::subscribe(current);
+    }
+};
+
+/**
+ * Keeps alive the object owning a semaphore a storage waits on
+ */
+template <class Owner>
+struct semaphore_owner_holder {
+  std::shared_ptr<Owner> owner_;
+};
+
+template <class Func>
+class event_wait_group_storage : semaphore_owner_holder<semaphore>,
+                                 public event_semaphore_wait_base_storage {
+    internal::wait_group_state& state_;
+    Func func_;
+
+ public:
+    using func_type = Func;
+    using return_type = decltype(std::declval<Func>()());
+
+    static return_type execute(event_wait_group_storage* self, internal::event_type, bool) {
+        return self->func_();
+    }
+
+    // The gate must be read before the counter
+    event_wait_group_storage(wait_group& group, Func&& cb)
+        : semaphore_owner_holder<semaphore>{std::atomic_load(&group.impl_->gate_)},
+          event_semaphore_wait_base_storage{*owner_},
+          state_{*group.impl_},
+          func_{std::move(cb)} {
+    }
+
+    event_wait_group_storage(wait_group& group, Func const& cb)
+        : semaphore_owner_holder<semaphore>{std::atomic_load(&group.impl_->gate_)},
+          event_semaphore_wait_base_storage{*owner_},
+          state_{*group.impl_},
+          func_{cb} {
+    }
+
+    /**
+     * The gate is never posted, it is disabled when the counter gets to zero
+     *
+     * The gate is taken anew every time, an event kept in a selector would
+     * otherwise stay on the gate opened by a previous use of the group.
+     */
+    inline bool poll() {
+      owner_ = std::atomic_load(&state_.gate_);
+      rebind(*owner_);
+      return 0 == state_.count_.load() || event_semaphore_wait_base_storage::poll();
+    }
+
+    inline bool subscribe(internal::routine* current) {
+      return poll() || event_semaphore_wait_base_storage::subscribe(current);
+    }
+};
+
+template <class Func>
+class event_barrier_wait_storage : semaphore_owner_holder<internal::barrier_phase>,
+                                   public event_semaphore_wait_base_storage {
+    Func func_;
+
+ public:
+    using func_type = Func;
+    using return_type = decltype(std::declval<Func>()());
+
+    static return_type execute(event_barrier_wait_storage* self, internal::event_type, bool) {
+        return self->func_();
+    }
+
+    event_barrier_wait_storage(barrier_token const& token, Func&& cb)
+        : semaphore_owner_holder<internal::barrier_phase>{token.phase_},
+          event_semaphore_wait_base_storage{owner_->gate_},
+          func_{std::move(cb)} {
+    }
+
+    event_barrier_wait_storage(barrier_token const& token, Func const& cb)
+        : semaphore_owner_holder<internal::barrier_phase>{token.phase_},
+          event_semaphore_wait_base_storage{owner_->gate_},
+          func_{cb} {
+    }
+};
+
+template <class Func>
+class event_condition_wait_storage
+    : semaphore_owner_holder<internal::condition_variable_state>,
+      public event_semaphore_wait_base_storage {
+    Func func_;
+
+ public:
+    using func_type = Func;
+    using return_type = decltype(std::declval<Func>()());
+
+    static return_type execute(event_condition_wait_storage* self, internal::event_type, bool) {
+        return self->func_();
+    }
+
+    event_condition_wait_storage(condition_variable& cond, Func&& cb)
+        : semaphore_owner_holder<internal::condition_variable_state>{cond.impl_},
+          event_semaphore_wait_base_storage{owner_->notifications_},
+          func_{std::move(cb)} {
+    }
+
+    event_condition_wait_storage(condition_variable& cond, Func const& cb)
+        : semaphore_owner_holder<internal::condition_variable_state>{cond.impl_},
+          event_semaphore_wait_base_storage{owner_->notifications_},
+          func_{cb} {
+    }
+};
+
+template <class Result, class Func>
+class event_join_storage : semaphore_owner_holder<internal::routine_result<Result>>,
+                           public event_semaphore_wait_base_storage {
+    Func func_;
+
+ public:
+    using func_type = Func;
+    using return_type = decltype(std::declval<Func>()());
+
+    static return_type execute(event_join_storage* self, internal::event_type, bool) {
+        return self->func_();
+    }
+
+    event_join_storage(routine_handle<Result> const& handle, Func&& cb)
+        : semaphore_owner_holder<internal::routine_result<Result>>{handle.result_},
+          event_semaphore_wait_base_storage{this->owner_->done_},
+          func_{std::move(cb)} {
+    }
+
+    event_join_storage(routine_handle<Result> const& handle, Func const& cb)
+        : semaphore_owner_holder<internal::routine_result<Result>>{handle.result_},
+          event_semaphore_wait_base_storage{this->owner_->done_},
           func_{cb} {
     }
 };
 
 template <class ContentType, std::size_t Size, class Func>
 class event_channel_read_storage : public event_semaphore_wait_base_storage {
+    static_assert(0 < Size, "Unbuffered channels cannot be used in a select statement.");
     channel<ContentType,Size>& channel_;
     ContentType& value_;
     Func func_;
@@ -192,9 +477,11 @@ class event_channel_read_storage : public event_semaphore_wait_base_storage {
     using func_type = Func;
     using return_type = decltype(std::declval<Func>()(bool{}));
 
-    static return_type execute(event_channel_read_storage* self, internal::event_type type,bool) {
-        self->channel_.consume_read(self->value_);
-        return self->func_(type == internal::event_type::sema_wait);
+    static return_type execute(event_channel_read_storage* self, internal::event_type type,
+                               bool event_round_cancelled) {
+        bool success = self->got_ticket(type, event_round_cancelled);
+        if (success) self->channel_.consume_read(self->value_);
+        return self->func_(success);
     }
 
     event_channel_read_storage(channel_type& channel, ContentType& value, Func&& cb)
@@ -214,6 +501,7 @@ class event_channel_read_storage : public event_semaphore_wait_base_storage {
 
 template <class ContentType, std::size_t Size, class Func>
 class event_channel_write_storage : public event_semaphore_wait_base_storage {
+    static_assert(0 < Size, "Unbuffered channels cannot be used in a select statement.");
     channel<ContentType,Size>& channel_;
     ContentType value_;
     Func func_;
@@ -223,9 +511,11 @@ class event_channel_write_storage : public event_semaphore_wait_base_storage {
     using func_type = Func;
     using return_type = decltype(std::declval<Func>()(bool{}));
 
-    static return_type execute(event_channel_write_storage* self, internal::event_type type,bool) {
-        self->channel_.consume_write(std::move(self->value_));
-        return self->func_(type == internal::event_type::sema_wait);
+    static return_type execute(event_channel_write_storage* self, internal::event_type type,
+                               bool event_round_cancelled) {
+        bool success = self->got_ticket(type, event_round_cancelled);
+        if (success) success = self->channel_.consume_write(std::move(self->value_));
+        return self->func_(success);
     }
 
     event_channel_write_storage(channel_type& channel, ContentType value, Func&& cb)
@@ -237,6 +527,49 @@ class event_channel_write_storage : public event_semaphore_wait_base_storage {
     }
 };
 
+/**
+ * Branch taken by select_any when no other event is ready
+ */
+template <class Func>
+class event_default_storage {
+    Func func_;
+
+ public:
+    using func_type = Func;
+    using return_type = decltype(std::declval<Func>()());
+
+    static return_type execute(event_default_storage* self, internal::event_type, bool) {
+        return self->func_();
+    }
+
+    event_default_storage(Func&& cb) : func_{std::move(cb)} {
+    }
+
+    event_default_storage(Func const& cb) : func_{cb} {
+    }
+
+    bool poll() {
+        return false;
+    }
+};
+
+template <class Selector>
+struct is_default_event : std::false_type {};
+
+template <class Func>
+struct is_default_event<event_default_storage<Func>> : std::true_type {};
+
+template <class ... Selectors>
+struct count_default_events;
+
+template <>
+struct count_default_events<> : std::integral_constant<std::size_t, 0> {};
+
+template <class Selector, class ... Selectors>
+struct count_default_events<Selector, Selectors...>
+    : std::integral_constant<std::size_t, is_default_event<Selector>::value +
+                                              count_default_events<Selectors...>::value> {};
+
 template <class Selector, class ReturnType> 
 auto make_selector_execute() -> decltype(auto) {
   return [](void* data, internal::event_type type, bool event_round_cancelled) -> ReturnType {
@@ -251,6 +584,133 @@ auto make_selector_subscribe() -> decltype(auto) {
   };
 }
 
+template <class Selector> 
+auto make_selector_poll() -> decltype(auto) {
+  return [](void* data) -> bool {
+    return static_cast<Selector*>(data)->poll();
+  };
+}
+
+// Executes the event and drops whatever the callback returns
+template <class Selector> 
+auto make_selector_discarding_execute() -> decltype(auto) {
+  return [](void* data, internal::event_type type, bool event_round_cancelled) -> void {
+    Selector::execute(static_cast<Selector*>(data), type, event_round_cancelled);
+  };
+}
+
+// select_any without a default branch : subscribe and suspend
+template <class ReturnType, class ... Selectors> 
+ReturnType select_any_impl(std::false_type, Selectors& ... selectors) {
+  static std::array<bool (*)(void*, internal::routine*), sizeof...(Selectors)> subscribers{
+      internal::select_impl::make_selector_subscribe<Selectors>()...};
+  static std::array<ReturnType (*)(void*, internal::event_type, bool), sizeof...(Selectors)>
+      callers{internal::select_impl::make_selector_execute<Selectors, ReturnType>()...};
+  std::array<void*, sizeof...(Selectors)> selector_ptrs{(&selectors)...};
+
+  internal::thread* this_thread = internal::current_thread();
+  internal::routine* current_routine = this_thread->running_routine();
+  current_routine->start_event_round();
+
+  bool cancel = false;
+  size_t index = 0;
+  for (; index < sizeof ... (Selectors); ++index) {
+    cancel = (*subscribers[index])(selector_ptrs[index],current_routine);
+    if (cancel)
+        break;
+  }
+  if (cancel) {
+    current_routine->cancel_event_round();
+    //yield();
+  }
+  else {
+    current_routine->commit_event_round();
+    index = current_routine->happened_index();
+  }
+  return (*callers[index])(selector_ptrs[index], current_routine->happened_type(), cancel);
+}
+
+// select_any with a default branch : poll every event once, never suspend
+template <class ReturnType, class ... Selectors> 
+ReturnType select_any_impl(std::true_type, Selectors& ... selectors) {
+  static std::array<bool (*)(void*), sizeof...(Selectors)> pollers{
+      internal::select_impl::make_selector_poll<Selectors>()...};
+  static std::array<ReturnType (*)(void*, internal::event_type, bool), sizeof...(Selectors)>
+      callers{internal::select_impl::make_selector_execute<Selectors, ReturnType>()...};
+  static std::array<bool, sizeof...(Selectors)> defaults{is_default_event<Selectors>::value...};
+  std::array<void*, sizeof...(Selectors)> selector_ptrs{(&selectors)...};
+
+  size_t default_index = 0;
+  for (size_t index = 0; index < sizeof ... (Selectors); ++index) {
+    if (defaults[index])
+      default_index = index;
+    else if ((*pollers[index])(selector_ptrs[index]))
+      return (*callers[index])(selector_ptrs[index], internal::event_type::none, true);
+  }
+  return (*callers[default_index])(selector_ptrs[default_index], internal::event_type::none, true);
+}
+
+template <class ... Selectors> 
+std::array<bool, sizeof...(Selectors)> select_all_impl(routine_time_point const* deadline,
+                                                       Selectors& ... selectors) {
+  constexpr size_t nb_selectors = sizeof...(Selectors);
+  static std::array<bool (*)(void*), nb_selectors> pollers{
+      internal::select_impl::make_selector_poll<Selectors>()...};
+  static std::array<bool (*)(void*, internal::routine*), nb_selectors> subscribers{
+      internal::select_impl::make_selector_subscribe<Selectors>()...};
+  static std::array<void (*)(void*, internal::event_type, bool), nb_selectors> callers{
+      internal::select_impl::make_selector_discarding_execute<Selectors>()...};
+  std::array<void*, nb_selectors> selector_ptrs{(&selectors)...};
+  std::array<bool, nb_selectors> happened{};
+  std::array<size_t, nb_selectors> subscribed;  // Selector of every event of the round
+  size_t nb_happened = 0;
+
+  internal::routine* current_routine = internal::current_thread()->running_routine();
+  auto execute = [&](size_t index, internal::event_type type, bool event_round_cancelled) {
+    (*callers[index])(selector_ptrs[index], type, event_round_cancelled);
+    happened[index] = true;
+    ++nb_happened;
+  };
+
+  while (nb_happened < nb_selectors) {
+    // Gather whatever is ready without registering anything
+    bool progressed = false;
+    for (size_t index = 0; index < nb_selectors; ++index) {
+      if (!happened[index] && (*pollers[index])(selector_ptrs[index])) {
+        execute(index, internal::event_type::none, true);
+        progressed = true;
+      }
+    }
+    if (progressed) continue;
+    if (deadline &&
+        *deadline <= std::chrono::time_point_cast<std::chrono::milliseconds>(
+                         std::chrono::high_resolution_clock::now()))
+      break;
+
+    // Then wait for the first of the others, event rounds end on their
+    // first event so the next ones are registered again by the next round
+    current_routine->start_event_round();
+    size_t nb_subscribed = 0;
+    bool cancel = false;
+    for (size_t index = 0; index < nb_selectors && !cancel; ++index) {
+      if (happened[index]) continue;
+      cancel = (*subscribers[index])(selector_ptrs[index], current_routine);
+      subscribed[nb_subscribed++] = index;
+    }
+    if (cancel) {
+      current_routine->cancel_event_round();
+      execute(subscribed[nb_subscribed - 1], current_routine->happened_type(), true);
+      continue;
+    }
+    if (deadline) current_routine->add_timer(*deadline);
+    current_routine->commit_event_round();
+    size_t rank = current_routine->happened_index();
+    if (nb_subscribed <= rank) break;
+    execute(subscribed[rank], current_routine->happened_type(), false);
+  }
+  return happened;
+}
+
 }
 }
 
@@ -280,9 +740,63 @@ event_recv(fd_t fd, void* buf, size_t count, int flags, Func&& cb) {
 }
 
 template <class Func> 
-internal::select_impl::event_syscall_storage<Func, SYS_accept, socket_t, sockaddr*, socklen_t*>
+internal::select_impl::event_syscall_storage<Func, SYS_recvfrom, socket_t, void*, size_t, int, sockaddr *, socklen_t *>
+event_recvfrom(socket_t socket, void* buf, size_t count, int flags, sockaddr* address, socklen_t* address_len, Func&& cb) {
+    return {std::forward<Func>(cb),socket,buf,count,flags,address,address_len,0};
+}
+
+template <class Func> 
+internal::select_impl::event_syscall_storage<Func, SYS_sendto, socket_t, const void*, size_t, int, const sockaddr *, socklen_t>
+event_sendto(socket_t socket, const void* buf, size_t count, int flags, const sockaddr* address, socklen_t address_len, Func&& cb) {
+    return {std::forward<Func>(cb),socket,buf,count,flags,address,address_len,0};
+}
+
+template <class Func> 
+internal::select_impl::event_syscall_storage<Func, SYS_readv, fd_t, const iovec*, int>
+event_readv(fd_t fd, const iovec* iov, int iovcnt, Func&& cb) {
+    return {std::forward<Func>(cb),fd,iov,iovcnt,0};
+}
+
+template <class Func> 
+internal::select_impl::event_syscall_storage<Func, SYS_writev, fd_t, const iovec*, int>
+event_writev(fd_t fd, const iovec* iov, int iovcnt, Func&& cb) {
+    return {std::forward<Func>(cb),fd,iov,iovcnt,0};
+}
+
+template <class Func> 
+internal::select_impl::event_syscall_storage<Func, SYS_recvmsg, socket_t, msghdr*, int>
+event_recvmsg(socket_t socket, msghdr* message, int flags, Func&& cb) {
+    return {std::forward<Func>(cb),socket,message,flags,0};
+}
+
+template <class Func> 
+internal::select_impl::event_syscall_storage<Func, SYS_sendmsg, socket_t, const msghdr*, int>
+event_sendmsg(socket_t socket, const msghdr* message, int flags, Func&& cb) {
+    return {std::forward<Func>(cb),socket,message,flags,0};
+}
+
+template <class Func> 
+internal::select_impl::event_syscall_storage<Func, SYS_recvmmsg, socket_t, mmsghdr*, unsigned int, int, timespec*>
+event_recvmmsg(socket_t socket, mmsghdr* messages, unsigned int count, int flags, Func&& cb) {
+    return {std::forward<Func>(cb),socket,messages,count,flags,nullptr,0};
+}
+
+template <class Func> 
+internal::select_impl::event_syscall_storage<Func, SYS_sendmmsg, socket_t, mmsghdr*, unsigned int, int>
+event_sendmmsg(socket_t socket, mmsghdr* messages, unsigned int count, int flags, Func&& cb) {
+    return {std::forward<Func>(cb),socket,messages,count,flags,0};
+}
+
+template <class Func> 
+internal::select_impl::event_syscall_storage<Func, SYS_accept4, socket_t, sockaddr*, socklen_t*, int>
 event_accept(socket_t socket, sockaddr* address, socklen_t* address_len, Func&& cb) {
-    return {std::forward<Func>(cb), socket, address, address_len, 0};
+    return {std::forward<Func>(cb), socket, address, address_len, accepted_socket_flags, 0};
+}
+
+template <class Func> 
+internal::select_impl::event_accept_many_storage<Func>
+event_accept_many(socket_t socket, socket_t* sockets, std::size_t count, Func&& cb) {
+    return {std::forward<Func>(cb), socket, sockets, count, 0};
 }
 
 template <class Func> 
@@ -309,6 +823,49 @@ event_lock(mutex& mut, Func&& cb) {
   return {mut, std::forward<Func>(cb)};
 }
 
+template <class Func>
+internal::select_impl::event_shared_mutex_lock_storage<Func>
+event_lock_shared(shared_mutex& mut, Func&& cb) {
+  return {mut, std::forward<Func>(cb)};
+}
+
+template <class Func>
+internal::select_impl::event_wait_group_storage<Func>
+event_wait(wait_group& group, Func&& cb) {
+  return {group, std::forward<Func>(cb)};
+}
+
+template <class Func>
+internal::select_impl::event_barrier_wait_storage<Func>
+event_wait(barrier_token const& token, Func&& cb) {
+  return {token, std::forward<Func>(cb)};
+}
+
+/**
+ * Waits for a notification of the condition variable
+ *
+ * The select does not handle any mutex, it must be unlocked before and
+ * locked back afterwards. The routine only counts as a waiter once the
+ * select subscribed, notifications sent in between are missed : the
+ * condition should be checked again after a timeout.
+ */
+template <class Func>
+internal::select_impl::event_condition_wait_storage<Func>
+event_wait(condition_variable& cond, Func&& cb) {
+  return {cond, std::forward<Func>(cb)};
+}
+
+/**
+ * Waits for a joinable routine to finish
+ *
+ * The result is then available through the handle.
+ */
+template <class Result, class Func>
+internal::select_impl::event_join_storage<Result, Func>
+event_join(routine_handle<Result> const& handle, Func&& cb) {
+  return {handle, std::forward<Func>(cb)};
+}
+
 template <class ContentType, std::size_t Size, class Func>
 internal::select_impl::event_channel_read_storage<ContentType, Size, Func>
 event_read(channel<ContentType,Size>& chan, ContentType& value, Func&& cb) {
@@ -322,37 +879,56 @@ event_write(channel<ContentType,Size>& chan, ContentType value, Func&& cb) {
 }
 
 
+/**
+ * Branch executed by select_any when no other event is ready right away
+ *
+ * With a default branch, select_any polls every event once and never
+ * suspends nor registers anything.
+ */
+template <class Func>
+internal::select_impl::event_default_storage<Func> event_default(Func&& cb) {
+  return {std::forward<Func>(cb)};
+}
+
 template <class ... Selectors> 
 auto select_any(Selectors&& ... selectors) 
     -> std::common_type_t<typename Selectors::return_type ...>
 {
   using return_type = std::common_type_t<typename Selectors::return_type...>;
-  static std::array<bool (*)(void*, internal::routine*), sizeof...(Selectors)> subscribers{
-      internal::select_impl::make_selector_subscribe<Selectors>()...};
-  static std::array<return_type (*)(void*, internal::event_type, bool), sizeof...(Selectors)>
-      callers{internal::select_impl::make_selector_execute<Selectors, return_type>()...};
-  std::array<void*, sizeof...(Selectors)> selector_ptrs{(&selectors)...};
+  constexpr size_t nb_defaults = internal::select_impl::count_default_events<Selectors...>::value;
+  static_assert(nb_defaults <= 1, "select_any accepts a single default branch.");
+  return internal::select_impl::select_any_impl<return_type>(
+      std::integral_constant<bool, 0 < nb_defaults>{}, selectors...);
+}
 
-  internal::thread* this_thread = internal::current_thread();
-  internal::routine* current_routine = this_thread->running_routine();
-  current_routine->start_event_round();
+/**
+ * Waits until every event happened
+ *
+ * Events already ready are executed together without suspending, the
+ * routine only suspends when none is. Callbacks are executed as events
+ * happen, and their return values are dropped. Returns which events
+ * happened, that is all of them.
+ *
+ * This is not a single suspension : each wait registers the pending events
+ * again and resumes on the first of them. Events happening one at a time
+ * cost one suspension each, and registrations quadratic in their number.
+ */
+template <class ... Selectors> 
+std::array<bool, sizeof...(Selectors)> select_all(Selectors&& ... selectors) {
+  return internal::select_impl::select_all_impl(nullptr, selectors...);
+}
 
-  bool cancel = false;
-  size_t index = 0;
-  for (; index < sizeof ... (Selectors); ++index) {
-    cancel = (*subscribers[index])(selector_ptrs[index],current_routine);
-    if (cancel)
-        break;
-  }
-  if (cancel) {
-    current_routine->cancel_event_round();
-    //yield();
-  }
-  else {
-    current_routine->commit_event_round();
-    index = current_routine->happened_index();
-  }
-  return (*callers[index])(selector_ptrs[index], current_routine->happened_type(), cancel);
+/**
+ * Waits until every event happened or until the timeout expires
+ *
+ * Returns which events happened, the others have not been executed.
+ */
+template <class ... Selectors> 
+std::array<bool, sizeof...(Selectors)> select_all_for(std::chrono::milliseconds timeout,
+                                                      Selectors&& ... selectors) {
+  internal::routine_time_point deadline = std::chrono::time_point_cast<std::chrono::milliseconds>(
+      std::chrono::high_resolution_clock::now() + timeout);
+  return internal::select_impl::select_all_impl(&deadline, selectors...);
 }
 
 
@@ -0,0 +1,131 @@
+#ifndef BOSON_SELECTOR_H_
+#define BOSON_SELECTOR_H_
+
+#include <chrono>
+#include <memory>
+#include <type_traits>
+#include <vector>
+#include "select.h"
+#include "std/experimental/chrono.h"
+
+namespace boson {
+
+namespace internal {
+namespace select_impl {
+
+/**
+ * Type erased select event, as built by the event_* functions
+ */
+class selector_entry {
+ public:
+  virtual ~selector_entry() = default;
+  virtual bool subscribe(routine* current) = 0;
+  virtual void execute(event_type type, bool event_round_cancelled) = 0;
+};
+
+template <class Storage>
+class selector_entry_impl : public selector_entry {
+  Storage storage_;
+
+ public:
+  selector_entry_impl(Storage&& storage) : storage_{std::move(storage)} {
+  }
+
+  bool subscribe(routine* current) override {
+    return storage_.subscribe(current);
+  }
+
+  void execute(event_type type, bool event_round_cancelled) override {
+    Storage::execute(&storage_, type, event_round_cancelled);
+  }
+};
+
+}  // namespace select_impl
+}  // namespace internal
+
+/**
+ * select_any over a set of events known at run time
+ *
+ * Events are built with the same event_* functions as for select_any, and
+ * are kept from one select() call to the next, so waiting again on the same
+ * set costs no allocation. Every call starts subscribing with the event
+ * following the one it started with last time, so an always ready event
+ * cannot starve the others.
+ *
+ * Since events are kept, an event_timer fires at the same date for every
+ * call, select() takes a timeout instead. An event_write writes its value
+ * each time it is picked, it should be replaced once it succeeded.
+ *
+ * Callbacks must not modify the selector, the caller gets the index of the
+ * picked event to do so.
+ */
+class selector {
+  using entry_ptr = std::unique_ptr<internal::select_impl::selector_entry>;
+  std::vector<entry_ptr> entries_;
+  std::size_t start_ = 0;
+
+  template <class Event>
+  static entry_ptr make_entry(Event&& event) {
+    using storage_type = std::decay_t<Event>;
+    return entry_ptr{
+        new internal::select_impl::selector_entry_impl<storage_type>{std::forward<Event>(event)}};
+  }
+
+  int select_impl(int timeout_ms);
+
+ public:
+  selector() = default;
+  selector(selector const&) = delete;
+  selector(selector&&) = default;
+  selector& operator=(selector const&) = delete;
+  selector& operator=(selector&&) = default;
+  ~selector() = default;
+
+  /**
+   * Adds an event and returns its index
+   */
+  template <class Event>
+  std::size_t add(Event&& event) {
+    entries_.emplace_back(make_entry(std::forward<Event>(event)));
+    return entries_.size() - 1;
+  }
+
+  /**
+   * Replaces the event at index
+   */
+  template <class Event>
+  void replace(std::size_t index, Event&& event) {
+    entries_[index] = make_entry(std::forward<Event>(event));
+  }
+
+  /**
+   * Removes the event at index, following events are shifted down
+   */
+  void erase(std::size_t index);
+
+  void clear();
+
+  inline std::size_t size() const;
+
+  /**
+   * Waits for one of the events and executes its callback
+   *
+   * Returns the index of the picked event, or -1 on timeout.
+   */
+  int select();
+  int select(std::chrono::milliseconds const& timeout);
+  template <class T_Rep, class T_Period>
+  inline int select(std::chrono::duration<T_Rep, T_Period> const& timeout) {
+    return select(experimental::chrono::ceil<std::chrono::milliseconds>(timeout));
+  }
+};
+
+// inline implementations
+
+std::size_t selector::size() const {
+  return entries_.size();
+}
+
+}  // namespace boson
+
+#endif  // BOSON_SELECTOR_H_
@@ -3,11 +3,11 @@
 
 #include <memory>
 #include <chrono>
-#include <mutex>
+#include <cstdint>
 #include "internal/routine.h"
 #include "internal/thread.h"
 #include "queues/lcrq.h"
-#include "queues/vectorized_queue.h"
+#include "queues/waiter_queue.h"
 
 namespace boson {
 
@@ -23,6 +23,8 @@ class event_channel_write_storage;
 }
 }
 
+class condition_variable;
+
 enum class semaphore_return_value { ok, timedout, disabled };
 
 struct semaphore_result {
@@ -42,9 +44,10 @@ struct semaphore_result {
  *
  * The boson semaphore may only be used from routines.
  */
-class semaphore : public std::enable_shared_from_this<semaphore> {
+class semaphore {
   friend class internal::thread;
   friend class internal::routine;
+  friend class condition_variable;
   friend class internal::select_impl::event_semaphore_wait_base_storage;
   template <class>
   friend class internal::select_impl::event_mutex_lock_storage;
@@ -56,11 +59,53 @@ class semaphore : public std::enable_shared_from_this<semaphore> {
   static constexpr int disabling_threshold = 0x40000000;
   static constexpr int disabled_standpoint = 0x60000000;
 
-  using waiting_unit_t = std::pair<internal::thread*,std::size_t>;
-  using queue_t = queues::vectorized_queue<waiting_unit_t>;
+  using queue_t = queues::waiter_queue<internal::thread>;
+  using waiting_unit_t = queue_t::value_type;
   queue_t waiters_;
-  std::mutex waiters_lock_;
-  std::atomic<int> counter_;
+
+  /**
+   * Tickets counter and number of routines in the waiters queue
+   *
+   * The counter, biased to stay positive, is in the low half and the number
+   * of waiters in the high half. A post learns from its single increment
+   * whether anyone has to be woken up, and a waiter enqueuing itself gives
+   * its ticket back and counts itself at once.
+   */
+  std::atomic<std::uint64_t> state_;
+
+  static constexpr std::int64_t counter_bias = std::int64_t{1} << 31;
+  static constexpr std::uint64_t one_waiter = std::uint64_t{1} << 32;
+
+  static inline int counter_of(std::uint64_t state) {
+    return static_cast<int>(static_cast<std::int64_t>(state & (one_waiter - 1)) - counter_bias);
+  }
+
+  static inline int nb_waiters_of(std::uint64_t state) {
+    return static_cast<int>(state >> 32);
+  }
+
+  // Takes a ticket, returns the counter before
+  inline int take_ticket() {
+    return counter_of(state_.fetch_sub(1, std::memory_order_acquire));
+  }
+
+  // Gives back a ticket taken from a disabled semaphore
+  inline void give_ticket_back() {
+    state_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  inline int counter() const {
+    return counter_of(state_.load(std::memory_order_acquire));
+  }
+
+  // Routines waiting for several tickets at once, also counted as waiters
+  std::atomic<int> nb_gatherers_;
+
+  // Disabled by posts to wake gatherers up, created by the first of them
+  std::shared_ptr<semaphore> gatherers_gate_;
+
+  // Handed to threads resuming waiters, to detect a semaphore being destroyed
+  std::weak_ptr<semaphore> self_;
 
   /**
    * tries to unlock a waiter
@@ -72,6 +117,32 @@ class semaphore : public std::enable_shared_from_this<semaphore> {
    * none could be poped
    */
   bool pop_a_waiter(internal::thread* current = nullptr);
+
+  /**
+   * Unlocks up to count waiters
+   */
+  void pop_waiters(internal::thread* current, int count);
+
+  /**
+   * Schedules a popped waiter
+   *
+   * Waiters of the current thread are scheduled right away, others through
+   * a command to their thread.
+   */
+  void wake_up(internal::thread* current, waiting_unit_t const& waiter);
+
+  // Gate gatherers wait on, created if none
+  std::shared_ptr<semaphore> gatherers_gate();
+
+  // Lets gatherers check the counter again
+  void wake_up_gatherers();
+
+  /**
+   * Enqueues a waiter that failed to take a ticket
+   *
+   * The ticket is given back, and a waiter is popped if the counter shows
+   * one got available meanwhile.
+   */
   size_t write(internal::thread* target, std::size_t index);
   bool read(waiting_unit_t& waiter); 
   bool free(size_t index);
@@ -79,11 +150,20 @@ class semaphore : public std::enable_shared_from_this<semaphore> {
  public:
   semaphore(int capacity);
   semaphore(semaphore const&) = delete;
-  semaphore(semaphore&&) = default;
+  semaphore(semaphore&&) = delete;
   semaphore& operator=(semaphore const&) = delete;
-  semaphore& operator=(semaphore&&) = default;
+  semaphore& operator=(semaphore&&) = delete;
   virtual ~semaphore();
 
+  /**
+   * Sets the object owning the semaphore memory
+   *
+   * Must be called once before any use. owner may be the semaphore itself or
+   * an object embedding it, sharing its allocation.
+   */
+  template <class Owner>
+  inline void set_owner(std::shared_ptr<Owner> const& owner);
+
   /**
    * Disable the semaphore for future uses of wait
    *
@@ -98,10 +178,32 @@ class semaphore : public std::enable_shared_from_this<semaphore> {
 
   inline semaphore_result wait(std::chrono::milliseconds);
 
+  /**
+   * Takes count tickets, suspending the routine until they are all available
+   *
+   * Tickets are taken all at once, none is held while waiting. On failure,
+   * no ticket is taken.
+   */
+  semaphore_result wait_n(int count, int timeout_ms = -1);
+
+  inline semaphore_result wait_n(int count, std::chrono::milliseconds timeout);
+
+  /**
+   * Takes up to count tickets without ever suspending
+   *
+   * Returns the number of tickets taken
+   */
+  int try_wait(int count = 1);
+
   /**
    * give back semaphore ticket. Always non blocking
    */
   semaphore_result post();
+
+  /**
+   * gives back count tickets at once, waking up as many waiters
+   */
+  semaphore_result post(int count);
 };
 
 
@@ -109,6 +211,26 @@ semaphore_result semaphore::wait(std::chrono::milliseconds timeout) {
   return wait(timeout.count());
 }
 
+semaphore_result semaphore::wait_n(int count, std::chrono::milliseconds timeout) {
+  return wait_n(count, timeout.count());
+}
+
+template <class Owner>
+void semaphore::set_owner(std::shared_ptr<Owner> const& owner) {
+  self_ = std::shared_ptr<semaphore>(owner, this);
+}
+
+namespace internal {
+/**
+ * Creates a semaphore owning itself
+ */
+inline std::shared_ptr<semaphore> make_semaphore(int capacity) {
+  auto sema = std::make_shared<semaphore>(capacity);
+  sema->set_owner(sema);
+  return sema;
+}
+}  // namespace internal
+
 /**
  * shared_semaphore is a wrapper for shared_ptr of a semaphore
  */
@@ -135,12 +257,16 @@ class shared_semaphore {
   inline void disable();
   inline semaphore_result wait(int timeout_ms = -1);
   inline semaphore_result wait(std::chrono::milliseconds timeout);
+  inline semaphore_result wait_n(int count, int timeout_ms = -1);
+  inline semaphore_result wait_n(int count, std::chrono::milliseconds timeout);
+  inline int try_wait(int count = 1);
   inline semaphore_result post();
+  inline semaphore_result post(int count);
 };
 
 // inline implementations
 
-shared_semaphore::shared_semaphore(int capacity) : impl_{new semaphore(capacity)} {
+shared_semaphore::shared_semaphore(int capacity) : impl_{internal::make_semaphore(capacity)} {
 }
 
 void shared_semaphore::disable() {
@@ -155,10 +281,26 @@ semaphore_result shared_semaphore::wait(std::chrono::milliseconds timeout) {
   return impl_->wait(timeout);
 }
 
+semaphore_result shared_semaphore::wait_n(int count, int timeout) {
+  return impl_->wait_n(count, timeout);
+}
+
+semaphore_result shared_semaphore::wait_n(int count, std::chrono::milliseconds timeout) {
+  return impl_->wait_n(count, timeout);
+}
+
+int shared_semaphore::try_wait(int count) {
+  return impl_->try_wait(count);
+}
+
 semaphore_result shared_semaphore::post() {
   return impl_->post();
 }
 
+semaphore_result shared_semaphore::post(int count) {
+  return impl_->post(count);
+}
+
 }  // namespace boson
 
 #endif  // BOSON_SEMAPHORE_H_
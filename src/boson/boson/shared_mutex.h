@@ -0,0 +1,89 @@
+#ifndef BOSON_SHARED_MUTEX_H_
+#define BOSON_SHARED_MUTEX_H_
+#include <atomic>
+#include "semaphore.h"
+
+namespace boson {
+
+namespace internal {
+namespace select_impl {
+template <class>
+class event_shared_mutex_lock_storage;
+}
+
+/**
+ * State shared by every copy of a shared_mutex
+ *
+ * Readers take one ticket each from readers_, a writer takes all of them.
+ * Writers line up on writers_ and hold it until they unlock, readers coming
+ * while a writer is around go through it as well, so they cannot starve it.
+ */
+struct shared_mutex_state {
+  static constexpr int max_readers = 0x10000000;
+
+  semaphore readers_;
+  semaphore writers_;
+
+  // Writers waiting for the lock or holding it
+  std::atomic<int> nb_writers_;
+
+  inline shared_mutex_state();
+};
+
+shared_mutex_state::shared_mutex_state() : readers_{max_readers}, writers_{1}, nb_writers_{0} {
+}
+
+}  // namespace internal
+
+/**
+ * Reader-writer lock for routines
+ *
+ * Any number of routines may hold the lock shared, or one holds it
+ * exclusively. Writers are preferred : once a writer waits, new readers wait
+ * after it. As a mutex, it is a shared pointer to its state and must be
+ * transfered by copy.
+ */
+class shared_mutex {
+  template <class>
+  friend class internal::select_impl::event_shared_mutex_lock_storage;
+  std::shared_ptr<internal::shared_mutex_state> impl_;
+
+ public:
+  shared_mutex();
+  shared_mutex(shared_mutex const&) = default;
+  shared_mutex(shared_mutex&&) = default;
+  shared_mutex& operator=(shared_mutex const&) = default;
+  shared_mutex& operator=(shared_mutex&&) = default;
+  ~shared_mutex() = default;
+
+  /**
+   * Takes the lock exclusively
+   *
+   * Fails if the timeout, in milliseconds, expires first. A negative
+   * timeout waits forever.
+   */
+  semaphore_result lock(int timeout = -1);
+  inline semaphore_result lock(std::chrono::milliseconds timeout);
+  void unlock();
+
+  /**
+   * Takes the lock along other readers
+   */
+  semaphore_result lock_shared(int timeout = -1);
+  inline semaphore_result lock_shared(std::chrono::milliseconds timeout);
+  void unlock_shared();
+};
+
+// inline implementations
+
+semaphore_result shared_mutex::lock(std::chrono::milliseconds timeout) {
+  return lock(timeout.count());
+}
+
+semaphore_result shared_mutex::lock_shared(std::chrono::milliseconds timeout) {
+  return lock_shared(timeout.count());
+}
+
+}  // namespace boson
+
+#endif  // BOSON_SHARED_MUTEX_H_
@@ -0,0 +1,331 @@
+#ifndef BOSON_SPSC_CHANNEL_H_
+#define BOSON_SPSC_CHANNEL_H_
+
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include "channel.h"
+#include "queues/weakrb.h"
+#include "select.h"
+#include "semaphore.h"
+
+namespace boson {
+
+template <class ContentType>
+class spsc_channel;
+
+namespace internal {
+namespace select_impl {
+template <class ContentType, class Func>
+class event_spsc_read_storage;
+template <class ContentType, class Func>
+class event_spsc_write_storage;
+}
+}
+
+/**
+ * Channel between exactly one producer and one consumer routine
+ *
+ * Both routines may run on different threads. Elements go through a weakrb
+ * ring, so the data path is lock free and wait free. A side only goes
+ * through a semaphore when it has to wait: it raises its parked flag and the
+ * other side wakes it up after its next operation.
+ *
+ * Using more than one producer or more than one consumer at a time is
+ * undefined behavior. As for channels, spsc channels must be given to
+ * routines by copy.
+ */
+template <class ContentType>
+class spsc_channel {
+  template <class Content, class Func>
+  friend class internal::select_impl::event_spsc_read_storage;
+  template <class Content, class Func>
+  friend class internal::select_impl::event_spsc_write_storage;
+
+  struct impl {
+    queues::weakrb<ContentType> ring;
+    std::atomic<bool> closed;
+    std::atomic<bool> reader_parked;
+    std::atomic<bool> writer_parked;
+    semaphore reader_wake_up;
+    semaphore writer_wake_up;
+
+    impl(std::size_t capacity)
+        : ring(capacity),
+          closed{false},
+          reader_parked{false},
+          writer_parked{false},
+          reader_wake_up(0),
+          writer_wake_up(0) {
+    }
+
+    /**
+     * Raises the parked flag and waits to be woken up
+     *
+     * Returns right away if ready() or if the channel is closed, and false on
+     * timeout. Wake ups may be spurious, the caller must check again.
+     */
+    template <class Ready>
+    bool park(std::atomic<bool>& parked, semaphore& wake_up, Ready ready, int timeout_ms) {
+      // Drop wake ups left by parks which ended otherwise
+      wake_up.try_wait(std::numeric_limits<int>::max());
+      parked.store(true, std::memory_order_relaxed);
+      // Pairs with the fence of wake_peer, one of both sides sees the other
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (ready() || closed.load(std::memory_order_relaxed)) {
+        parked.store(false, std::memory_order_relaxed);
+        return true;
+      }
+      return wake_up.wait(timeout_ms) != semaphore_return_value::timedout;
+    }
+
+    /**
+     * Wakes up the other side if it is parked
+     */
+    void wake_peer(std::atomic<bool>& parked, semaphore& wake_up) {
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (parked.load(std::memory_order_relaxed) &&
+          parked.exchange(false, std::memory_order_acq_rel))
+        wake_up.post();
+    }
+
+    bool try_read(ContentType& value) {
+      if (!ring.read(value)) return false;
+      wake_peer(writer_parked, writer_wake_up);
+      return true;
+    }
+
+    bool try_write(ContentType& value) {
+      if (!ring.write(std::move(value))) return false;
+      wake_peer(reader_parked, reader_wake_up);
+      return true;
+    }
+  };
+
+  std::shared_ptr<impl> impl_;
+
+  // Milliseconds left before the deadline, -1 if there is none
+  static int remaining(std::chrono::high_resolution_clock::time_point deadline,
+                       int timeout_ms) {
+    using namespace std::chrono;
+    if (timeout_ms < 0) return -1;
+    auto left = duration_cast<milliseconds>(deadline - high_resolution_clock::now()).count();
+    return 0 < left ? static_cast<int>(left) : 0;
+  }
+
+ public:
+  using value_type = ContentType;
+
+  explicit spsc_channel(std::size_t capacity) : impl_{std::make_shared<impl>(capacity)} {
+    impl_->reader_wake_up.set_owner(impl_);
+    impl_->writer_wake_up.set_owner(impl_);
+  }
+  spsc_channel(spsc_channel const&) = default;
+  spsc_channel(spsc_channel&&) = default;
+  spsc_channel& operator=(spsc_channel const&) = default;
+  spsc_channel& operator=(spsc_channel&&) = default;
+
+  /**
+   * Closes the channel
+   *
+   * Elements written before are still delivered to the consumer.
+   */
+  void close() {
+    impl_->closed.store(true, std::memory_order_release);
+    impl_->wake_peer(impl_->reader_parked, impl_->reader_wake_up);
+    impl_->wake_peer(impl_->writer_parked, impl_->writer_wake_up);
+  }
+
+  /**
+   * Write an element in the channel
+   *
+   * Returns false only if the channel is closed.
+   */
+  channel_result write(ContentType value, int timeout_ms = -1) {
+    impl& self = *impl_;
+    auto deadline =
+        std::chrono::high_resolution_clock::now() + std::chrono::milliseconds(timeout_ms);
+    for (;;) {
+      if (self.closed.load(std::memory_order_acquire)) return {channel_result_value::closed};
+      if (self.try_write(value)) return {channel_result_value::ok};
+      if (!self.park(self.writer_parked, self.writer_wake_up, [&self] { return !self.ring.full(); },
+                     remaining(deadline, timeout_ms))) {
+        return {self.try_write(value) ? channel_result_value::ok : channel_result_value::timedout};
+      }
+    }
+  }
+
+  channel_result read(ContentType& value, int timeout_ms = -1) {
+    impl& self = *impl_;
+    auto deadline =
+        std::chrono::high_resolution_clock::now() + std::chrono::milliseconds(timeout_ms);
+    for (;;) {
+      if (self.try_read(value)) return {channel_result_value::ok};
+      if (self.closed.load(std::memory_order_acquire)) {
+        // Something may have been written right before closing
+        return {self.ring.read(value) ? channel_result_value::ok : channel_result_value::closed};
+      }
+      if (!self.park(self.reader_parked, self.reader_wake_up, [&self] { return !self.ring.empty(); },
+                     remaining(deadline, timeout_ms))) {
+        return {self.try_read(value) ? channel_result_value::ok : channel_result_value::timedout};
+      }
+    }
+  }
+};
+
+template <class ContentType, class ValueType>
+inline auto operator<<(spsc_channel<ContentType>& channel, ValueType&& value) ->
+    typename std::enable_if<std::is_convertible<ValueType, ContentType>::value,
+                            channel_result>::type {
+  return channel.write(static_cast<ContentType>(std::forward<ValueType>(value)));
+}
+
+template <class ContentType>
+inline channel_result operator>>(spsc_channel<ContentType>& channel, ContentType& value) {
+  return channel.read(value);
+}
+
+namespace internal {
+namespace select_impl {
+
+/**
+ * Waits on the wake up semaphore of a spsc channel side
+ *
+ * The element is moved in subscribe when it is already there, otherwise
+ * execute finishes the operation. A wake up left by an earlier select may
+ * pick this event with nothing to read yet, execute then waits for it.
+ */
+template <class ContentType, class Func>
+class event_spsc_read_storage : public event_semaphore_wait_base_storage {
+  spsc_channel<ContentType>& channel_;
+  ContentType& value_;
+  bool done_ = false;
+  channel_result result_{channel_result_value::ok};
+  Func func_;
+
+ public:
+  using func_type = Func;
+  using return_type = decltype(std::declval<Func>()(bool{}));
+
+  static return_type execute(event_spsc_read_storage* self, internal::event_type, bool) {
+    if (!self->done_) self->result_ = self->channel_.read(self->value_);
+    return self->func_(self->result_);
+  }
+
+  event_spsc_read_storage(spsc_channel<ContentType>& channel, ContentType& value, Func&& cb)
+      : event_semaphore_wait_base_storage{channel.impl_->reader_wake_up},
+        channel_{channel},
+        value_{value},
+        func_{std::move(cb)} {
+  }
+
+  event_spsc_read_storage(spsc_channel<ContentType>& channel, ContentType& value,
+                          Func const& cb)
+      : event_semaphore_wait_base_storage{channel.impl_->reader_wake_up},
+        channel_{channel},
+        value_{value},
+        func_{cb} {
+  }
+
+  bool poll() {
+    auto& self = *channel_.impl_;
+    done_ = self.try_read(value_);
+    return done_ || self.closed.load(std::memory_order_acquire);
+  }
+
+  bool subscribe(internal::routine* current) {
+    auto& self = *channel_.impl_;
+    if (poll()) return true;
+    self.reader_wake_up.try_wait(std::numeric_limits<int>::max());
+    self.reader_parked.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!self.ring.empty() || self.closed.load(std::memory_order_relaxed)) {
+      self.reader_parked.store(false, std::memory_order_relaxed);
+      return true;
+    }
+    return event_semaphore_wait_base_storage::subscribe(current);
+  }
+};
+
+template <class ContentType, class Func>
+class event_spsc_write_storage : public event_semaphore_wait_base_storage {
+  spsc_channel<ContentType>& channel_;
+  ContentType value_;
+  bool done_ = false;
+  channel_result result_{channel_result_value::ok};
+  Func func_;
+
+ public:
+  using func_type = Func;
+  using return_type = decltype(std::declval<Func>()(bool{}));
+
+  static return_type execute(event_spsc_write_storage* self, internal::event_type, bool) {
+    if (!self->done_) self->result_ = self->channel_.write(std::move(self->value_));
+    return self->func_(self->result_);
+  }
+
+  event_spsc_write_storage(spsc_channel<ContentType>& channel, ContentType value, Func&& cb)
+      : event_semaphore_wait_base_storage{channel.impl_->writer_wake_up},
+        channel_{channel},
+        value_{std::move(value)},
+        func_{std::move(cb)} {
+  }
+
+  event_spsc_write_storage(spsc_channel<ContentType>& channel, ContentType value,
+                           Func const& cb)
+      : event_semaphore_wait_base_storage{channel.impl_->writer_wake_up},
+        channel_{channel},
+        value_{std::move(value)},
+        func_{cb} {
+  }
+
+  bool poll() {
+    auto& self = *channel_.impl_;
+    if (self.closed.load(std::memory_order_acquire)) {
+      result_ = {channel_result_value::closed};
+      done_ = true;
+      return true;
+    }
+    done_ = self.try_write(value_);
+    return done_;
+  }
+
+  bool subscribe(internal::routine* current) {
+    auto& self = *channel_.impl_;
+    if (poll()) return true;
+    self.writer_wake_up.try_wait(std::numeric_limits<int>::max());
+    self.writer_parked.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!self.ring.full() || self.closed.load(std::memory_order_relaxed)) {
+      self.writer_parked.store(false, std::memory_order_relaxed);
+      return true;
+    }
+    return event_semaphore_wait_base_storage::subscribe(current);
+  }
+};
+
+}  // namespace select_impl
+}  // namespace internal
+
+/**
+ * Reads from a spsc channel in a select_any call
+ */
+template <class ContentType, class Func>
+internal::select_impl::event_spsc_read_storage<ContentType, Func> event_read(
+    spsc_channel<ContentType>& chan, ContentType& value, Func&& cb) {
+  return {chan, value, std::forward<Func>(cb)};
+}
+
+/**
+ * Writes to a spsc channel in a select_any call
+ */
+template <class ContentType, class Func>
+internal::select_impl::event_spsc_write_storage<ContentType, Func> event_write(
+    spsc_channel<ContentType>& chan, ContentType value, Func&& cb) {
+  return {chan, std::move(value), std::forward<Func>(cb)};
+}
+
+}  // namespace boson
+
+#endif  // BOSON_SPSC_CHANNEL_H_
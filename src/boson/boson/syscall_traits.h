@@ -62,6 +62,29 @@ template <> struct add_timer<false> {
   }
 };
 
+/**
+ * Flags given to accept4 for every accepted socket
+ *
+ * Boson sockets must be non blocking, and this spares the extra fcntl calls
+ */
+constexpr int const accepted_socket_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+
+/**
+ * Accepts pending connections until EAGAIN or until count is reached
+ *
+ * Never suspends the routine. Returns the number of accepted sockets.
+ */
+inline std::size_t drain_accept_backlog(socket_t socket, socket_t* sockets, std::size_t count) {
+  std::size_t nb_accepted = 0;
+  while (nb_accepted < count) {
+    socket_t new_socket =
+        syscall_callable<SYS_accept4>::call(socket, nullptr, nullptr, accepted_socket_flags);
+    if (new_socket < 0) break;
+    sockets[nb_accepted++] = new_socket;
+  }
+  return nb_accepted;
+}
+
 template <int SyscallId> struct syscall_traits;
 
 template <> struct syscall_traits<SYS_read> {
@@ -80,10 +103,38 @@ template <> struct syscall_traits<SYS_sendto> {
   static constexpr bool is_read = false;
 };
 
+template <> struct syscall_traits<SYS_readv> {
+  static constexpr bool is_read = true;
+};
+
+template <> struct syscall_traits<SYS_writev> {
+  static constexpr bool is_read = false;
+};
+
+template <> struct syscall_traits<SYS_recvmsg> {
+  static constexpr bool is_read = true;
+};
+
+template <> struct syscall_traits<SYS_sendmsg> {
+  static constexpr bool is_read = false;
+};
+
+template <> struct syscall_traits<SYS_recvmmsg> {
+  static constexpr bool is_read = true;
+};
+
+template <> struct syscall_traits<SYS_sendmmsg> {
+  static constexpr bool is_read = false;
+};
+
 template <> struct syscall_traits<SYS_accept> {
   static constexpr bool is_read = true;
 };
 
+template <> struct syscall_traits<SYS_accept4> {
+  static constexpr bool is_read = true;
+};
+
 template <> struct syscall_traits<SYS_connect> {
   static constexpr bool is_read = false;
 };
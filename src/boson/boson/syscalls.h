@@ -2,6 +2,7 @@
 #define BOSON_SYSCALLS_H_
 
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <chrono>
 #include <cstdint>
 #include <utility>
@@ -18,6 +19,15 @@ namespace boson {
  */
 void yield();
 
+/**
+ * Suspends the routine and resumes it in the given thread
+ *
+ * The routine must not use objects bound to its current thread, such as
+ * local channels, once migrated. Migrating to the current thread does
+ * nothing, migrating to a thread that does not exist throws.
+ */
+void migrate_to(std::size_t thread_id);
+
 
 /**
  * Suspends the routine for the given duration
@@ -57,6 +67,47 @@ inline ssize_t write(fd_t fd, const void *buf, size_t count,
   return write(fd, buf, count, experimental::chrono::ceil<std::chrono::milliseconds>(timeout));
 }
 
+ssize_t readv(fd_t fd, const iovec *iov, int iovcnt, std::chrono::milliseconds const &timeout);
+template <class T_Rep, class T_Period>
+inline ssize_t readv(fd_t fd, const iovec *iov, int iovcnt,
+                     std::chrono::duration<T_Rep, T_Period> const &timeout) {
+  return readv(fd, iov, iovcnt, experimental::chrono::ceil<std::chrono::milliseconds>(timeout));
+}
+
+ssize_t writev(fd_t fd, const iovec *iov, int iovcnt, std::chrono::milliseconds const &timeout);
+template <class T_Rep, class T_Period>
+inline ssize_t writev(fd_t fd, const iovec *iov, int iovcnt,
+                      std::chrono::duration<T_Rep, T_Period> const &timeout) {
+  return writev(fd, iov, iovcnt, experimental::chrono::ceil<std::chrono::milliseconds>(timeout));
+}
+
+ssize_t sendfile(fd_t out_fd, fd_t in_fd, off_t *offset, size_t count,
+                 std::chrono::milliseconds const &timeout);
+template <class T_Rep, class T_Period>
+inline ssize_t sendfile(fd_t out_fd, fd_t in_fd, off_t *offset, size_t count,
+                        std::chrono::duration<T_Rep, T_Period> const &timeout) {
+  return sendfile(out_fd, in_fd, offset, count,
+                  experimental::chrono::ceil<std::chrono::milliseconds>(timeout));
+}
+
+ssize_t splice(fd_t fd_in, loff_t *off_in, fd_t fd_out, loff_t *off_out, size_t length,
+               unsigned int flags, std::chrono::milliseconds const &timeout);
+template <class T_Rep, class T_Period>
+inline ssize_t splice(fd_t fd_in, loff_t *off_in, fd_t fd_out, loff_t *off_out, size_t length,
+                      unsigned int flags, std::chrono::duration<T_Rep, T_Period> const &timeout) {
+  return splice(fd_in, off_in, fd_out, off_out, length, flags,
+                experimental::chrono::ceil<std::chrono::milliseconds>(timeout));
+}
+
+ssize_t tee(fd_t fd_in, fd_t fd_out, size_t length, unsigned int flags,
+            std::chrono::milliseconds const &timeout);
+template <class T_Rep, class T_Period>
+inline ssize_t tee(fd_t fd_in, fd_t fd_out, size_t length, unsigned int flags,
+                   std::chrono::duration<T_Rep, T_Period> const &timeout) {
+  return tee(fd_in, fd_out, length, flags,
+             experimental::chrono::ceil<std::chrono::milliseconds>(timeout));
+}
+
 socket_t accept(socket_t socket, sockaddr *address, socklen_t *address_len,
                 std::chrono::milliseconds const &timeout_ms);
 template <class T_Rep, class T_Period>
@@ -66,6 +117,15 @@ inline socket_t accept(socket_t socket, sockaddr *address, socklen_t *address_le
                 experimental::chrono::ceil<std::chrono::milliseconds>(timeout));
 }
 
+ssize_t accept_many(socket_t socket, socket_t *sockets, size_t count,
+                    std::chrono::milliseconds const &timeout_ms);
+template <class T_Rep, class T_Period>
+inline ssize_t accept_many(socket_t socket, socket_t *sockets, size_t count,
+                           std::chrono::duration<T_Rep, T_Period> const &timeout) {
+  return accept_many(socket, sockets, count,
+                     experimental::chrono::ceil<std::chrono::milliseconds>(timeout));
+}
+
 int connect(socket_t sockfd, const sockaddr *addr, socklen_t addrlen,
             std::chrono::milliseconds const &timeout);
 template <class T_Rep, class T_Period>
@@ -92,6 +152,63 @@ inline ssize_t recv(socket_t socket, void *buffer, size_t length, int flags,
   return recv(socket, buffer, length, flags, experimental::chrono::ceil<std::chrono::milliseconds>(timeout));
 }
 
+ssize_t sendto(socket_t socket, const void *buffer, size_t length, int flags,
+               const sockaddr *address, socklen_t address_len,
+               std::chrono::milliseconds const &timeout);
+template <class T_Rep, class T_Period>
+inline ssize_t sendto(socket_t socket, const void *buffer, size_t length, int flags,
+                      const sockaddr *address, socklen_t address_len,
+                      std::chrono::duration<T_Rep, T_Period> const &timeout) {
+  return sendto(socket, buffer, length, flags, address, address_len,
+                experimental::chrono::ceil<std::chrono::milliseconds>(timeout));
+}
+
+ssize_t recvfrom(socket_t socket, void *buffer, size_t length, int flags, sockaddr *address,
+                 socklen_t *address_len, std::chrono::milliseconds const &timeout);
+template <class T_Rep, class T_Period>
+inline ssize_t recvfrom(socket_t socket, void *buffer, size_t length, int flags,
+                        sockaddr *address, socklen_t *address_len,
+                        std::chrono::duration<T_Rep, T_Period> const &timeout) {
+  return recvfrom(socket, buffer, length, flags, address, address_len,
+                  experimental::chrono::ceil<std::chrono::milliseconds>(timeout));
+}
+
+ssize_t sendmsg(socket_t socket, const msghdr *message, int flags,
+                std::chrono::milliseconds const &timeout);
+template <class T_Rep, class T_Period>
+inline ssize_t sendmsg(socket_t socket, const msghdr *message, int flags,
+                       std::chrono::duration<T_Rep, T_Period> const &timeout) {
+  return sendmsg(socket, message, flags,
+                 experimental::chrono::ceil<std::chrono::milliseconds>(timeout));
+}
+
+ssize_t recvmsg(socket_t socket, msghdr *message, int flags,
+                std::chrono::milliseconds const &timeout);
+template <class T_Rep, class T_Period>
+inline ssize_t recvmsg(socket_t socket, msghdr *message, int flags,
+                       std::chrono::duration<T_Rep, T_Period> const &timeout) {
+  return recvmsg(socket, message, flags,
+                 experimental::chrono::ceil<std::chrono::milliseconds>(timeout));
+}
+
+int sendmmsg(socket_t socket, mmsghdr *messages, unsigned int count, int flags,
+             std::chrono::milliseconds const &timeout);
+template <class T_Rep, class T_Period>
+inline int sendmmsg(socket_t socket, mmsghdr *messages, unsigned int count, int flags,
+                    std::chrono::duration<T_Rep, T_Period> const &timeout) {
+  return sendmmsg(socket, messages, count, flags,
+                  experimental::chrono::ceil<std::chrono::milliseconds>(timeout));
+}
+
+int recvmmsg(socket_t socket, mmsghdr *messages, unsigned int count, int flags,
+             std::chrono::milliseconds const &timeout);
+template <class T_Rep, class T_Period>
+inline int recvmmsg(socket_t socket, mmsghdr *messages, unsigned int count, int flags,
+                    std::chrono::duration<T_Rep, T_Period> const &timeout) {
+  return recvmmsg(socket, messages, count, flags,
+                  experimental::chrono::ceil<std::chrono::milliseconds>(timeout));
+}
+
 // Boson equivalents to POSIX systemcalls
 
 unsigned int sleep(unsigned int duration_seconds);
@@ -107,10 +224,50 @@ socket_t socket(int domain, int type, int protocol);
 
 ssize_t read(fd_t fd, void *buf, size_t count);
 ssize_t write(fd_t fd, const void *buf, size_t count);
+ssize_t readv(fd_t fd, const iovec *iov, int iovcnt);
+ssize_t writev(fd_t fd, const iovec *iov, int iovcnt);
+
+/**
+ * Zero-copy transfers
+ *
+ * Both ends may not be ready at the same time, so these calls suspend on
+ * whichever end is not ready until the transfer can happen. splice and tee
+ * always add SPLICE_F_NONBLOCK to the given flags.
+ */
+ssize_t sendfile(fd_t out_fd, fd_t in_fd, off_t *offset, size_t count);
+ssize_t splice(fd_t fd_in, loff_t *off_in, fd_t fd_out, loff_t *off_out, size_t length,
+               unsigned int flags);
+ssize_t tee(fd_t fd_in, fd_t fd_out, size_t length, unsigned int flags);
 socket_t accept(socket_t socket, sockaddr *address, socklen_t *address_len);
 int connect(socket_t sockfd, const sockaddr *addr, socklen_t addrlen);
 ssize_t send(socket_t socket, const void *buffer, size_t length, int flags);
 ssize_t recv(socket_t socket, void *buffer, size_t length, int flags);
+ssize_t sendto(socket_t socket, const void *buffer, size_t length, int flags,
+               const sockaddr *address, socklen_t address_len);
+ssize_t recvfrom(socket_t socket, void *buffer, size_t length, int flags, sockaddr *address,
+                 socklen_t *address_len);
+ssize_t sendmsg(socket_t socket, const msghdr *message, int flags);
+ssize_t recvmsg(socket_t socket, msghdr *message, int flags);
+
+/**
+ * Multi-message versions of sendmsg and recvmsg
+ *
+ * They suspend until the socket is ready, then transfer as many messages as
+ * possible in a single syscall. They return the number of messages sent or
+ * received.
+ */
+int sendmmsg(socket_t socket, mmsghdr *messages, unsigned int count, int flags);
+int recvmmsg(socket_t socket, mmsghdr *messages, unsigned int count, int flags);
+
+/**
+ * Accepts up to count connections in a single wake up
+ *
+ * Suspends until at least one connection is pending, then drains the
+ * backlog until EAGAIN or until count sockets have been accepted. Accepted
+ * sockets are non blocking and close-on-exec. Returns the number of
+ * accepted sockets, or -1 with errno set if none could be accepted.
+ */
+ssize_t accept_many(socket_t socket, socket_t *sockets, size_t count);
 
 // Versions with C++11 durations
 
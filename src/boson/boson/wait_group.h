@@ -0,0 +1,83 @@
+#ifndef BOSON_WAIT_GROUP_H_
+#define BOSON_WAIT_GROUP_H_
+#include <atomic>
+#include "semaphore.h"
+
+namespace boson {
+
+namespace internal {
+namespace select_impl {
+template <class>
+class event_wait_group_storage;
+}
+
+/**
+ * State shared by every copy of a wait_group
+ *
+ * Waiters suspend on gate_, which never holds any ticket. When the counter
+ * drops to zero, the gate is replaced and the old one is disabled, which
+ * wakes up every waiter at once.
+ */
+struct wait_group_state {
+  std::atomic<int> count_;
+  std::shared_ptr<semaphore> gate_;
+
+  inline wait_group_state();
+};
+
+wait_group_state::wait_group_state() : count_{0}, gate_{make_semaphore(0)} {
+}
+
+}  // namespace internal
+
+/**
+ * Waits for a collection of routines to finish
+ *
+ * Similar to the Go sync.WaitGroup : add() counts tasks, done() is called
+ * by each of them when finished and wait() suspends until the count is zero.
+ * The group may be reused once waiters are woken up.
+ */
+class wait_group {
+  template <class>
+  friend class internal::select_impl::event_wait_group_storage;
+  std::shared_ptr<internal::wait_group_state> impl_;
+
+ public:
+  inline wait_group();
+  wait_group(wait_group const&) = default;
+  wait_group(wait_group&&) = default;
+  wait_group& operator=(wait_group const&) = default;
+  wait_group& operator=(wait_group&&) = default;
+  ~wait_group() = default;
+
+  /**
+   * Adds delta to the counter
+   *
+   * Throws if the counter gets negative.
+   */
+  void add(int delta = 1);
+  inline void done();
+
+  /**
+   * Suspends the routine until the counter is zero
+   */
+  semaphore_result wait(int timeout = -1);
+  inline semaphore_result wait(std::chrono::milliseconds timeout);
+};
+
+// inline implementations
+
+wait_group::wait_group() : impl_{std::make_shared<internal::wait_group_state>()} {
+}
+
+void wait_group::done() {
+  add(-1);
+}
+
+semaphore_result wait_group::wait(std::chrono::milliseconds timeout) {
+  return wait(timeout.count());
+}
+
+}  // namespace boson
+
+#endif  // BOSON_WAIT_GROUP_H_
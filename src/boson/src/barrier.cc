@@ -0,0 +1,45 @@
+#include "boson/barrier.h"
+#include "boson/exception.h"
+
+namespace boson {
+
+namespace {
+
+std::shared_ptr<internal::barrier_phase> make_phase(int nb_participants) {
+  auto phase = std::make_shared<internal::barrier_phase>(nb_participants);
+  phase->gate_.set_owner(phase);
+  return phase;
+}
+
+}  // namespace
+
+namespace internal {
+
+barrier_state::barrier_state(int nb_participants)
+    : nb_participants_{nb_participants}, phase_{make_phase(nb_participants)} {
+}
+
+}  // namespace internal
+
+barrier::barrier(int nb_participants) {
+  if (nb_participants <= 0) throw boson::exception("boson::barrier needs at least one participant");
+  impl_ = std::make_shared<internal::barrier_state>(nb_participants);
+}
+
+barrier_token barrier::arrive() {
+  auto phase = std::atomic_load(&impl_->phase_);
+  if (1 == phase->remaining_.fetch_sub(1)) {
+    // Next phase first, so that routines woken up arrive at it
+    std::atomic_store(&impl_->phase_, make_phase(impl_->nb_participants_));
+    phase->gate_.disable();
+  }
+  return {std::move(phase)};
+}
+
+semaphore_result barrier::wait(barrier_token const& token, int timeout) {
+  auto result = token.phase_->gate_.wait(timeout);
+  return {result == semaphore_return_value::timedout ? semaphore_return_value::timedout
+                                                     : semaphore_return_value::ok};
+}
+
+}  // namespace boson
@@ -0,0 +1,38 @@
+#include "boson/condition_variable.h"
+#include <algorithm>
+#include <limits>
+
+namespace boson {
+
+condition_variable::condition_variable()
+    : impl_{std::make_shared<internal::condition_variable_state>()} {
+  impl_->notifications_.set_owner(impl_);
+}
+
+int condition_variable::missing_tickets(int count) const {
+  // Routines waiting in a select are only known once in the semaphore queue
+  auto notifications = impl_->notifications_.state_.load(std::memory_order_acquire);
+  int nb_waiting = std::max(impl_->nb_waiting_.load(), semaphore::nb_waiters_of(notifications));
+  int nb_tickets = std::max(0, semaphore::counter_of(notifications));
+  return std::min(count, nb_waiting - nb_tickets);
+}
+
+semaphore_result condition_variable::wait(mutex& mut, int timeout) {
+  impl_->nb_waiting_.fetch_add(1);
+  mut.unlock();
+  auto result = impl_->notifications_.wait(timeout);
+  impl_->nb_waiting_.fetch_sub(1);
+  mut.lock();
+  return result;
+}
+
+void condition_variable::notify_one() {
+  if (0 < missing_tickets(1)) impl_->notifications_.post();
+}
+
+void condition_variable::notify_all() {
+  int count = missing_tickets(std::numeric_limits<int>::max());
+  if (0 < count) impl_->notifications_.post(count);
+}
+
+}  // namespace boson
@@ -17,6 +17,11 @@ void netpoller_platform_impl::register_fd(fd_t fd)
   loop_->register_fd(fd);
 }
 
+void netpoller_platform_impl::register_listening_fd(fd_t fd, bool exclusive)
+{
+  loop_->register_listening_fd(fd, exclusive);
+}
+
 void netpoller_platform_impl::unregister(fd_t fd)
 {
   loop_->unregister(fd);
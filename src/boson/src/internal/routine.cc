@@ -1,5 +1,8 @@
 #include "internal/routine.h"
+#include <atomic>
 #include <cassert>
+#include <mutex>
+#include <vector>
 #include "exception.h"
 #include "internal/thread.h"
 #include "syscalls.h"
@@ -17,22 +20,75 @@ void resume_routine(transfer_t transfered_context) {
   routine* current_routine = this_thread->running_routine();
   current_routine->status_ = routine_status::running;
   (*current_routine->func_)();
+  // Still in the routine, so that destructors may suspend
+  current_routine->clear_locals();
   current_routine->status_ = routine_status::finished;
-  jump_fcontext(this_thread->context().fctx, nullptr);
+  // The routine may have migrated to another thread meanwhile
+  jump_fcontext(current_thread()->context().fctx, nullptr);
 }
 }
 
+namespace {
+// Keys are rarely created, they are not worth a lock free list
+struct routine_local_keys {
+  std::mutex lock;
+  std::vector<std::size_t> free_indexes;
+  std::size_t next_index = 0;
+  // Zero is the generation of empty slots
+  std::size_t next_generation = 1;
+};
+
+routine_local_keys& local_keys() {
+  // Never destroyed, routine_local objects may be static
+  static routine_local_keys* keys = new routine_local_keys;
+  return *keys;
+}
+}  // namespace
+
+routine_local_key new_routine_local_key() {
+  auto& keys = local_keys();
+  std::lock_guard<std::mutex> guard(keys.lock);
+  std::size_t index = keys.next_index;
+  if (keys.free_indexes.empty()) {
+    ++keys.next_index;
+  } else {
+    index = keys.free_indexes.back();
+    keys.free_indexes.pop_back();
+  }
+  return {index, keys.next_generation++};
+}
+
+void free_routine_local_key(routine_local_key key) {
+  auto& keys = local_keys();
+  std::lock_guard<std::mutex> guard(keys.lock);
+  keys.free_indexes.push_back(key.index);
+}
+
 // class routine;
 
 routine::~routine() {
+  clear_locals();
   deallocate(stack_);
 }
 
+void routine::clear_locals() {
+  // A destructor may use other routine_local objects, slots are not kept
+  // while destroying
+  while (!locals_.empty()) {
+    auto locals = std::move(locals_);
+    locals_.clear();
+    for (auto& slot : locals) {
+      if (slot.value) slot.destroy(slot.value);
+    }
+  }
+}
+
 void routine::start_event_round() {
   // Clean previous events
   //previous_events_.clear();
   //std::swap(previous_events_, events_);
   events_.clear();
+  nb_pending_candidacies_ = 0;
   // Create new event pointer
   current_ptr_ = routine_local_ptr_t(std::unique_ptr<routine>(this));
 }
@@ -40,12 +96,8 @@ void routine::start_event_round() {
 void routine::add_semaphore_wait(semaphore* sema) {
   events_.emplace_back(waited_event{event_type::sema_wait, routine_sema_event_data{sema,0,0}});
   auto slot_index = thread_->register_semaphore_wait(routine_slot{current_ptr_,events_.size()-1});
-  events_.back().data.get<routine_sema_event_data>().index = sema->write(thread_, slot_index);
   events_.back().data.get<routine_sema_event_data>().slot_index = slot_index;
-  int result = sema->counter_.fetch_add(1,std::memory_order_release);
-  if (0 <= result) {
-    sema->pop_a_waiter(thread_);
-  }
+  events_.back().data.get<routine_sema_event_data>().index = sema->write(thread_, slot_index);
 }
 
 void routine::add_timer(routine_time_point date) {
@@ -60,6 +112,12 @@ void routine::add_read(int fd) {
   thread_->register_read(fd, routine_slot{current_ptr_, events_.size() - 1});
 }
 
+routine_slot routine::add_local_wait() {
+  events_.emplace_back(waited_event{event_type::local_wait, nullptr});
+  ++thread_->nb_suspended_routines_;
+  return routine_slot{current_ptr_, events_.size() - 1};
+}
+
 void routine::add_write(int fd) {
   events_.emplace_back(waited_event{event_type::io_write, routine_io_event{fd, -1, fd_status::unknown, fd_status::unknown}});
   thread_->register_write(fd, routine_slot{current_ptr_, events_.size() - 1});
@@ -85,6 +143,7 @@ void routine::cancel_event_round() {
         --thread_->nb_suspended_routines_;
         break;
       case event_type::io_write:
+      case event_type::local_wait:
         --thread_->nb_suspended_routines_;
         break;
       case event_type::sema_wait: {
@@ -109,6 +168,7 @@ void routine::cancel_event_round() {
 
 void routine::set_as_semaphore_event_candidate(std::size_t index) {
   status_ = routine_status::sema_event_candidate;
+  ++nb_pending_candidacies_;
   thread_->schedule_routine(routine_slot{current_ptr_,index});
 }
 
@@ -142,9 +202,9 @@ bool routine::event_happened(std::size_t index, event_status status) {
       --thread_->nb_suspended_routines_;
       auto sema = event.data.get<routine_sema_event_data>().sema;
       thread_->unregister_expired_slot(event.data.get<routine_sema_event_data>().slot_index);
-      int result = sema->counter_.fetch_sub(1,std::memory_order_acquire);
+      int result = sema->take_ticket();
       if (semaphore::disabling_threshold < result) {
-        sema->counter_.fetch_add(1,std::memory_order_relaxed);
+        sema->give_ticket_back();
         happened_type_ = event_type::sema_closed;
       }
       else if (result <= 0) {
@@ -155,10 +215,6 @@ bool routine::event_happened(std::size_t index, event_status status) {
         auto slot_index =
             thread_->register_semaphore_wait(routine_slot{current_ptr_, index});
         event.data.get<routine_sema_event_data>().index = sema->write(thread_, slot_index);
-        result = sema->counter_.fetch_add(1, std::memory_order_release);
-        if (0 <= result) {
-          sema->pop_a_waiter(thread_);
-        }
         return false;
       }
       else {
@@ -168,6 +224,11 @@ bool routine::event_happened(std::size_t index, event_status status) {
     case event_type::sema_closed:
       assert(false);
       break;
+    case event_type::local_wait:
+      happened_type_ = event_type::local_wait;
+      happened_rc_ = status;
+      --thread_->nb_suspended_routines_;
+      break;
   }
 
   // invalidate other events
@@ -185,6 +246,7 @@ bool routine::event_happened(std::size_t index, event_status status) {
           --thread_->nb_suspended_routines_;
           break;
         case event_type::io_write:
+        case event_type::local_wait:
           --thread_->nb_suspended_routines_;
           break;
         case event_type::sema_wait: {
@@ -202,7 +202,6 @@ void thread::push_command(thread_id from, std::unique_ptr<thread_command> comman
 };
 
 bool thread::execute_scheduled_routines() {
-  decltype(scheduled_routines_) next_scheduled_routines;
   while (!scheduled_routines_.empty()) {
     // For now; we schedule them in order
     auto& slot = scheduled_routines_.front();
@@ -216,6 +215,7 @@ bool thread::execute_scheduled_routines() {
              slot.ptr->get()->status() == routine_status::is_new ||
              slot.ptr->get()->status() == routine_status::sema_event_candidate);
       if (routine->status() == routine_status::sema_event_candidate) {
+        --routine->nb_pending_candidacies_;
         run_routine = routine->event_happened(slot.event_index);
         // If success, get back the unique ownership of the routine
         if (run_routine) {
@@ -235,16 +235,24 @@ bool thread::execute_scheduled_routines() {
         } break;
         case routine_status::yielding: {
           // If not finished, then we reschedule it
-          next_scheduled_routines.emplace_back(
+          next_scheduled_routines_.emplace_back(
               routine_slot{routine_local_ptr_t(routine_ptr_t(slot.ptr->release())), 0});
         } break;
         case routine_status::wait_events: {
           slot.ptr->release();
         } break;
+        case routine_status::migrating: {
+          // Resumed as a yielding routine by the target thread
+          routine->status_ = routine_status::yielding;
+          engine_proxy_.start_routine(routine->migration_target_,
+                                      routine_ptr_t(slot.ptr->release()));
+        } break;
         case routine_status::sema_event_candidate: {
           // Thats means no event happened for the routine, so we must let the slot pointer
-          // untouched for other events to stay valid
-          routine->status_ = routine_status::wait_events;
+          // untouched for other events to stay valid. Another semaphore may
+          // have scheduled the routine as well, it stays a candidate for it.
+          if (0 == routine->nb_pending_candidacies_)
+            routine->status_ = routine_status::wait_events;
         } break;
         case routine_status::finished: {
           // Should have been made by the routine by closing the FD
@@ -255,7 +263,7 @@ bool thread::execute_scheduled_routines() {
   }
 
   // Yielded routines are immediately scheduled
-  scheduled_routines_ = std::move(next_scheduled_routines);
+  std::swap(scheduled_routines_, next_scheduled_routines_);
 
   // Cleanup canceled timers
   auto first_timed_routines = begin(timed_routines_);
@@ -386,6 +394,27 @@ void thread::signal_fd_closed(fd_t fd) {
   event_loop_.signal_fd_closed(fd);
 }
 
+void thread::watch_listening_fd(fd_t fd, bool exclusive) {
+  event_loop_.signal_new_listening_fd(fd, exclusive);
+}
+
+bool thread::wake_up_semaphore_waiter(semaphore* sema, std::size_t slot_index) {
+  auto& shared_routine = suspended_slots_[slot_index];
+  if (shared_routine.ptr) {
+    // A routine subscribing to a new round still runs, whatever its status
+    auto status = shared_routine.ptr->get()->status();
+    if (status != routine_status::wait_events && status != routine_status::sema_event_candidate)
+      return false;
+    shared_routine.ptr->get()->set_as_semaphore_event_candidate(shared_routine.event_index);
+  }
+  else {
+    // Invalidated by a timeout, the ticket goes to someone else
+    sema->pop_a_waiter(this);
+    suspended_slots_.free(slot_index);
+  }
+  return true;
+}
+
 void thread::schedule_routine(routine_slot&& slot) {
   assert(slot.ptr->get()->status() == routine_status::yielding || slot.ptr->get()->status() == routine_status::is_new || slot.ptr->get()->status() == routine_status::sema_event_candidate);
   scheduled_routines_.emplace_back(std::move(slot));
@@ -64,6 +64,23 @@ void io_event_loop::register_fd(int fd) {
   }
 }
 
+void io_event_loop::register_listening_fd(int fd, bool exclusive) {
+  // Listening sockets do not need EPOLLOUT, and EPOLLEXCLUSIVE only accepts
+  // EPOLLIN, EPOLLOUT, EPOLLWAKEUP and EPOLLET
+  uint32_t flags = EPOLLIN | EPOLLET;
+#ifdef EPOLLEXCLUSIVE
+  if (exclusive) flags |= EPOLLEXCLUSIVE;
+#endif
+  epoll_event_t new_event{ flags, {}};
+  new_event.data.fd = fd;
+  int return_code = ::epoll_ctl(loop_fd_, EPOLL_CTL_ADD, fd, &new_event);
+  // The socket may already have been closed by another thread, the next
+  // syscall on it will report it
+  if (return_code < 0 && errno != EBADF) {
+    throw exception(std::string("Syscall error (epoll_ctl): ") + ::strerror(errno));
+  }
+}
+
 void* io_event_loop::unregister(int fd) {
   // Since the FD is only supposed to be unregistered when closed 
   // there is no apparent reasion to explicitely del it. But, as stated by
@@ -118,6 +135,12 @@ io_loop_end_reason io_event_loop::wait(int timeout_ms) {
           if (epoll_event.events & EPOLLIN) {
             handler_.read(epoll_event.data.fd, interrupted ? -EINTR : 0);
           }
+          else if (epoll_event.events & EPOLLERR) {
+            // An error alone wakes readers up so that they retry and get it.
+            // This is also how error queue notifications, such as zero-copy
+            // completions, are signaled
+            handler_.read(epoll_event.data.fd, 0);
+          }
           if (epoll_event.events & EPOLLOUT) {
             handler_.write(epoll_event.data.fd, interrupted ? -EINTR : 0);
           }
@@ -74,6 +74,7 @@ class io_event_loop {
 
   void interrupt();
   void register_fd(int fd);
+  void register_listening_fd(int fd, bool exclusive);
   void* unregister(int fd);
   void* get_data(int event_id);
   void send_event(int event);
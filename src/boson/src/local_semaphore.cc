@@ -0,0 +1,83 @@
+#include "boson/local_semaphore.h"
+#include <algorithm>
+#include <cassert>
+
+using namespace std::chrono;
+
+namespace boson {
+
+// Woken up routines tell apart a ticket from a disabled semaphore with the
+// status of their event
+namespace {
+constexpr event_status ticket_given = 0;
+constexpr event_status semaphore_disabled = 1;
+}
+
+local_semaphore::local_semaphore(int capacity) : counter_{capacity} {
+}
+
+void local_semaphore::check_thread() {
+  internal::thread* this_thread = internal::current_thread();
+  if (!thread_) thread_ = this_thread;
+  assert(thread_ == this_thread && "local_semaphore used from two different threads");
+}
+
+bool local_semaphore::wake_up_a_waiter(event_status status) {
+  while (!waiters_.empty()) {
+    internal::routine_slot slot = std::move(waiters_.front());
+    waiters_.pop_front();
+    // Routines which timed out are skipped
+    if (slot.ptr) {
+      slot.ptr->get()->event_happened(slot.event_index, status);
+      return true;
+    }
+  }
+  return false;
+}
+
+void local_semaphore::disable() {
+  check_thread();
+  counter_ = disabled_standpoint;
+  while (wake_up_a_waiter(semaphore_disabled))
+    ;
+}
+
+semaphore_result local_semaphore::wait(int timeout) {
+  using namespace internal;
+  check_thread();
+  if (counter_ == disabled_standpoint) return {semaphore_return_value::disabled};
+  if (0 < counter_) {
+    --counter_;
+    return {semaphore_return_value::ok};
+  }
+
+  routine* current_routine = thread_->running_routine();
+  current_routine->start_event_round();
+  waiters_.emplace_back(current_routine->add_local_wait());
+  if (0 <= timeout) {
+    current_routine->add_timer(
+        time_point_cast<milliseconds>(high_resolution_clock::now() + milliseconds(timeout)));
+  }
+  current_routine->commit_event_round();
+  current_routine->previous_status_ = routine_status::wait_events;
+  current_routine->status_ = routine_status::running;
+  if (current_routine->happened_type_ != event_type::local_wait) {
+    // The slot of a timed out routine is invalidated, it would stay otherwise
+    waiters_.erase(std::remove_if(waiters_.begin(), waiters_.end(),
+                                  [](routine_slot const& slot) { return !slot.ptr; }),
+                   waiters_.end());
+    return {semaphore_return_value::timedout};
+  }
+  return {current_routine->happened_rc_ == ticket_given ? semaphore_return_value::ok
+                                                         : semaphore_return_value::disabled};
+}
+
+semaphore_result local_semaphore::post() {
+  check_thread();
+  if (counter_ == disabled_standpoint) return {semaphore_return_value::disabled};
+  // The ticket goes straight to a waiter if any
+  if (!wake_up_a_waiter(ticket_given)) ++counter_;
+  return {semaphore_return_value::ok};
+}
+
+}  // namespace boson
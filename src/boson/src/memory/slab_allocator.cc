@@ -0,0 +1,186 @@
+#include "boson/memory/slab_allocator.h"
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+
+namespace boson {
+namespace memory {
+
+namespace {
+
+constexpr std::size_t nb_size_classes = slab_max_size / slab_alignment;
+constexpr std::size_t span_size = 64 * 1024;
+
+struct heap;
+
+// Precedes every block, blocks from the default allocator have no owner
+struct alignas(slab_alignment) block_header {
+  heap* owner;
+  std::size_t size_class;
+};
+
+static_assert(sizeof(block_header) == slab_alignment, "Blocks would not be aligned");
+
+// Free blocks are chained through their content
+struct free_block {
+  free_block* next;
+};
+
+inline free_block* as_free_block(block_header* header) {
+  return reinterpret_cast<free_block*>(header + 1);
+}
+
+inline block_header* header_of(void* block) {
+  return static_cast<block_header*>(block) - 1;
+}
+
+struct heap {
+  free_block* free_lists[nb_size_classes] = {};
+  // Blocks freed by other threads
+  std::atomic<free_block*> returned{nullptr};
+  char* span_position = nullptr;
+  char* span_end = nullptr;
+  heap* next_abandoned = nullptr;
+
+  /**
+   * Moves returned blocks to the free lists
+   *
+   * Only the owner takes the list, and takes it whole, so there is no ABA
+   * problem with pushes from other threads.
+   */
+  void take_returned() {
+    free_block* block = returned.exchange(nullptr, std::memory_order_acquire);
+    while (block) {
+      free_block* next = block->next;
+      auto header = reinterpret_cast<block_header*>(block) - 1;
+      block->next = free_lists[header->size_class];
+      free_lists[header->size_class] = block;
+      block = next;
+    }
+  }
+
+  void give_back(free_block* block) {
+    free_block* head = returned.load(std::memory_order_relaxed);
+    do {
+      block->next = head;
+    } while (!returned.compare_exchange_weak(head, block, std::memory_order_release,
+                                             std::memory_order_relaxed));
+  }
+
+  block_header* carve(std::size_t size_class) {
+    std::size_t block_size = (size_class + 2) * slab_alignment;
+    if (span_end - span_position < static_cast<std::ptrdiff_t>(block_size)) {
+      // The tail of the previous span is lost, it is smaller than a block
+      span_position = static_cast<char*>(::operator new(span_size));
+      span_end = span_position + span_size;
+    }
+    auto header = reinterpret_cast<block_header*>(span_position);
+    span_position += block_size;
+    header->owner = this;
+    header->size_class = size_class;
+    return header;
+  }
+
+  void* allocate(std::size_t size_class) {
+    if (!free_lists[size_class]) take_returned();
+    free_block* block = free_lists[size_class];
+    if (block) {
+      free_lists[size_class] = block->next;
+      return block;
+    }
+    return carve(size_class) + 1;
+  }
+};
+
+// Heaps of finished threads, waiting for a new one
+struct abandoned_heaps {
+  std::mutex lock;
+  heap* first = nullptr;
+};
+
+abandoned_heaps& abandoned() {
+  // Never destroyed, threads may finish after static destruction
+  static abandoned_heaps* heaps = new abandoned_heaps;
+  return *heaps;
+}
+
+thread_local heap* local_heap = nullptr;
+thread_local bool heap_released = false;
+
+// Gives the heap of the thread away when it finishes
+struct heap_releaser {
+  ~heap_releaser() {
+    auto& heaps = abandoned();
+    std::lock_guard<std::mutex> guard(heaps.lock);
+    local_heap->next_abandoned = heaps.first;
+    heaps.first = local_heap;
+    local_heap = nullptr;
+    heap_released = true;
+  }
+};
+
+heap* acquire_heap() {
+  heap* acquired = nullptr;
+  {
+    auto& heaps = abandoned();
+    std::lock_guard<std::mutex> guard(heaps.lock);
+    acquired = heaps.first;
+    if (acquired) heaps.first = acquired->next_abandoned;
+  }
+  if (!acquired) acquired = new heap;
+  local_heap = acquired;
+  thread_local heap_releaser releaser;
+  return acquired;
+}
+
+void* allocate_unpooled(std::size_t size) {
+  auto header = static_cast<block_header*>(::operator new(sizeof(block_header) + size));
+  header->owner = nullptr;
+  return header + 1;
+}
+
+}  // namespace
+
+void* slab_allocate(std::size_t size) {
+  if (slab_max_size < size) return allocate_unpooled(size);
+  heap* owner = local_heap;
+  if (!owner) {
+    // Blocks allocated during the thread teardown are not worth a heap
+    if (heap_released) return allocate_unpooled(size);
+    owner = acquire_heap();
+  }
+  return owner->allocate(0 < size ? (size - 1) / slab_alignment : 0);
+}
+
+void slab_deallocate(void* block) noexcept {
+  if (!block) return;
+  block_header* header = header_of(block);
+  if (!header->owner) {
+    ::operator delete(header);
+  } else if (header->owner == local_heap) {
+    auto freed = as_free_block(header);
+    freed->next = local_heap->free_lists[header->size_class];
+    local_heap->free_lists[header->size_class] = freed;
+  } else {
+    header->owner->give_back(as_free_block(header));
+  }
+}
+
+void* slab_allocate(std::size_t size, std::size_t alignment) {
+  if (alignment <= slab_alignment) return slab_allocate(size);
+  if (std::numeric_limits<std::size_t>::max() - alignment < size) throw std::bad_alloc{};
+  // Blocks are aligned on slab_alignment, so there is room for the offset
+  auto start = reinterpret_cast<std::uintptr_t>(slab_allocate(size + alignment));
+  std::uintptr_t aligned = (start + alignment) & ~(alignment - 1);
+  reinterpret_cast<std::size_t*>(aligned)[-1] = aligned - start;
+  return reinterpret_cast<void*>(aligned);
+}
+
+void slab_deallocate(void* block, std::size_t alignment) noexcept {
+  if (!block || alignment <= slab_alignment) return slab_deallocate(block);
+  slab_deallocate(static_cast<char*>(block) - static_cast<std::size_t*>(block)[-1]);
+}
+
+}  // namespace memory
+}  // namespace boson
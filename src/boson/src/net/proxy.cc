@@ -0,0 +1,75 @@
+#include "boson/net/proxy.h"
+#include "boson/channel.h"
+#include "boson/internal/thread.h"
+#include "boson/syscalls.h"
+#include <sys/socket.h>
+
+namespace boson {
+namespace net {
+
+namespace {
+
+// Largest chunk moved in a single splice call
+constexpr size_t const splice_chunk_size = 1 << 16;
+
+/**
+ * Moves data from in to out until in reaches end of file
+ */
+void splice_one_way(socket_t in, socket_t out) {
+  fd_t pipe_fds[2];
+  if (boson::pipe(pipe_fds) < 0) {
+    ::shutdown(in, SHUT_RDWR);
+    ::shutdown(out, SHUT_RDWR);
+    return;
+  }
+
+  bool failed = false;
+  for (;;) {
+    ssize_t nb_pending = boson::splice(in, nullptr, pipe_fds[1], nullptr, splice_chunk_size,
+                                       SPLICE_F_MOVE | SPLICE_F_MORE);
+    if (nb_pending <= 0) {
+      failed = nb_pending < 0;
+      break;
+    }
+    // Always empty the pipe so that the next splice from in cannot block on it
+    while (0 < nb_pending) {
+      ssize_t nb_written = boson::splice(pipe_fds[0], nullptr, out, nullptr, nb_pending,
+                                         SPLICE_F_MOVE | SPLICE_F_MORE);
+      if (nb_written <= 0) break;
+      nb_pending -= nb_written;
+    }
+    if (0 < nb_pending) {
+      failed = true;
+      break;
+    }
+  }
+
+  if (failed) {
+    // Wake the other direction up so that it stops as well
+    ::shutdown(in, SHUT_RDWR);
+    ::shutdown(out, SHUT_RDWR);
+  }
+  else {
+    ::shutdown(out, SHUT_WR);
+  }
+  boson::close(pipe_fds[0]);
+  boson::close(pipe_fds[1]);
+}
+
+}  // namespace
+
+void proxy(socket_t socket_a, socket_t socket_b) {
+  channel<std::nullptr_t, 1> done;
+  start_local(
+      [](socket_t in, socket_t out, channel<std::nullptr_t, 1> done) -> void {
+        splice_one_way(in, out);
+        done << nullptr;
+      },
+      socket_b, socket_a, done);
+  splice_one_way(socket_a, socket_b);
+  std::nullptr_t dummy;
+  done >> dummy;
+}
+
+}  // namespace net
+}  // namespace boson
@@ -0,0 +1,14 @@
+#include "boson/net/sharded_listener.h"
+#include <sys/socket.h>
+
+namespace boson {
+namespace net {
+
+void stop_sharded_listeners(std::vector<socket_t> const& listeners) {
+  // A shut down listening socket wakes up its waiters and makes accept fail
+  for (auto listener : listeners) ::shutdown(listener, SHUT_RDWR);
+  for (auto listener : listeners) boson::close(listener);
+}
+
+}  // namespace net
+}  // namespace boson
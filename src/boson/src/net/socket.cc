@@ -12,15 +12,10 @@
 namespace boson {
 namespace net {
 
-socket_t create_listening_socket(
-    int port,
-    int max_connections,
-    int domain,
-    int type,
-    int protocol,
-    int non_block,
-    in_addr_t receive_from) {
+namespace {
 
+socket_t create_bound_socket(int port, int max_connections, int domain, int type, int protocol,
+                             in_addr_t receive_from, bool reuse_port) {
   sockaddr_in serv_addr;
   int sockfd = boson::socket(domain, type, protocol);
   //if (non_block) ::fcntl(sockfd, F_SETFL, O_NONBLOCK);
@@ -36,6 +31,10 @@ socket_t create_listening_socket(
   if (::setsockopt(sockfd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes)) < 0)
     throw boson::exception("setsockopt");
 
+  // share the port with other sockets
+  if (reuse_port && ::setsockopt(sockfd, SOL_SOCKET, SO_REUSEPORT, &yes, sizeof(yes)) < 0)
+    throw boson::exception("setsockopt (SO_REUSEPORT)");
+
   // bind it
   if (::bind(sockfd, reinterpret_cast<sockaddr*>(&serv_addr), sizeof(serv_addr)) < 0)
     throw boson::exception("ERROR on binding");
@@ -45,7 +44,59 @@ socket_t create_listening_socket(
   return sockfd;
 }
 
-    
+}  // namespace
+
+socket_t create_listening_socket(
+    int port,
+    int max_connections,
+    int domain,
+    int type,
+    int protocol,
+    int non_block,
+    in_addr_t receive_from) {
+  return create_bound_socket(port, max_connections, domain, type, protocol, receive_from, false);
+}
+
+socket_t create_sharded_listening_socket(
+    int port,
+    int max_connections,
+    int domain,
+    int type,
+    int protocol,
+    in_addr_t receive_from) {
+  return create_bound_socket(port, max_connections, domain, type, protocol, receive_from, true);
+}
+
+socket_t create_udp_socket(
+    int port,
+    int receive_buffer_size,
+    bool reuse_port,
+    int domain,
+    in_addr_t receive_from) {
+  sockaddr_in serv_addr;
+  int sockfd = boson::socket(domain, SOCK_DGRAM, 0);
+  if (sockfd < 0) throw boson::exception("ERROR opening socket");
+
+  ::memset(&serv_addr, 0, sizeof(serv_addr));
+  serv_addr.sin_family = domain;
+  serv_addr.sin_addr.s_addr = receive_from;
+  serv_addr.sin_port = htons(port);
+
+  int yes = 1;
+  if (reuse_port && ::setsockopt(sockfd, SOL_SOCKET, SO_REUSEPORT, &yes, sizeof(yes)) < 0)
+    throw boson::exception("setsockopt (SO_REUSEPORT)");
+
+  if (0 < receive_buffer_size &&
+      ::setsockopt(sockfd, SOL_SOCKET, SO_RCVBUF, &receive_buffer_size,
+                   sizeof(receive_buffer_size)) < 0)
+    throw boson::exception("setsockopt (SO_RCVBUF)");
+
+  // bind it
+  if (::bind(sockfd, reinterpret_cast<sockaddr*>(&serv_addr), sizeof(serv_addr)) < 0)
+    throw boson::exception("ERROR on binding");
+
+  return sockfd;
+}
 
 }  // namespace net
 }  // namespace boson
@@ -0,0 +1,251 @@
+#include "boson/net/stream.h"
+#include <sys/uio.h>
+#include <algorithm>
+#include <cstring>
+#include "boson/syscalls.h"
+
+namespace boson {
+namespace net {
+
+namespace {
+
+// A negative timeout means no timeout
+inline ssize_t read_with_timeout(socket_t socket, void* buffer, std::size_t count,
+                                 int timeout_ms) {
+  return timeout_ms < 0
+             ? boson::read(socket, buffer, count)
+             : boson::read(socket, buffer, count, std::chrono::milliseconds(timeout_ms));
+}
+
+/**
+ * Writes every byte described by iov, which is modified in the process
+ */
+ssize_t write_all(socket_t socket, iovec* iov, int iovcnt, int timeout_ms) {
+  while (0 < iovcnt) {
+    ssize_t rc = timeout_ms < 0
+                     ? boson::writev(socket, iov, iovcnt)
+                     : boson::writev(socket, iov, iovcnt, std::chrono::milliseconds(timeout_ms));
+    if (rc < 0) return -1;
+    std::size_t written = rc;
+    // Consumed entries are emptied, so that callers know what is left
+    while (0 < iovcnt && iov->iov_len <= written) {
+      written -= iov->iov_len;
+      iov->iov_len = 0;
+      ++iov;
+      --iovcnt;
+    }
+    if (0 < iovcnt) {
+      iov->iov_base = static_cast<char*>(iov->iov_base) + written;
+      iov->iov_len -= written;
+    }
+  }
+  return 0;
+}
+
+}  // namespace
+
+stream::stream(socket_t socket, std::size_t read_buffer_size, std::size_t write_buffer_size)
+    : socket_{socket},
+      read_buffer_{new char[read_buffer_size]},
+      read_capacity_{read_buffer_size},
+      write_buffer_{new char[write_buffer_size]},
+      write_capacity_{write_buffer_size} {
+}
+
+ssize_t stream::fill(int timeout_ms) {
+  // Whatever we wait for might be an answer to what has been written
+  if (0 < write_size_ && flush_impl(timeout_ms) < 0) return -1;
+  if (read_begin_ == read_end_) {
+    read_begin_ = read_end_ = 0;
+  }
+  else if (0 < read_begin_) {
+    std::memmove(read_buffer_.get(), read_buffer_.get() + read_begin_, buffered());
+    read_end_ -= read_begin_;
+    read_begin_ = 0;
+  }
+  ssize_t rc = read_with_timeout(socket_, read_buffer_.get() + read_end_,
+                                 read_capacity_ - read_end_, timeout_ms);
+  if (0 < rc) read_end_ += rc;
+  return rc;
+}
+
+std::size_t stream::take(void* buffer, std::size_t count) {
+  std::size_t nb_bytes = std::min(count, buffered());
+  std::memcpy(buffer, read_buffer_.get() + read_begin_, nb_bytes);
+  read_begin_ += nb_bytes;
+  return nb_bytes;
+}
+
+ssize_t stream::try_read(void* buffer, std::size_t count) {
+  if (0 == buffered()) {
+    read_begin_ = read_end_ = 0;
+    ssize_t rc = syscall_callable<SYS_read>::call(socket_, read_buffer_.get(), read_capacity_);
+    if (rc <= 0) return rc;
+    read_end_ = rc;
+  }
+  return take(buffer, count);
+}
+
+ssize_t stream::read_impl(void* buffer, std::size_t count, int timeout_ms) {
+  if (0 == buffered()) {
+    if (read_capacity_ <= count) {
+      // Large reads skip the buffer
+      if (0 < write_size_ && flush_impl(timeout_ms) < 0) return -1;
+      return read_with_timeout(socket_, buffer, count, timeout_ms);
+    }
+    ssize_t rc = fill(timeout_ms);
+    if (rc <= 0) return rc;
+  }
+  return take(buffer, count);
+}
+
+ssize_t stream::read_exact_impl(void* buffer, std::size_t count, int timeout_ms) {
+  if (count <= read_capacity_) {
+    while (buffered() < count) {
+      ssize_t rc = fill(timeout_ms);
+      if (rc < 0) return -1;
+      if (0 == rc) break;
+    }
+    return take(buffer, count);
+  }
+  std::size_t nb_read = 0;
+  while (nb_read < count) {
+    ssize_t rc = read_impl(static_cast<char*>(buffer) + nb_read, count - nb_read, timeout_ms);
+    if (rc < 0) return -1;
+    if (0 == rc) break;
+    nb_read += rc;
+  }
+  return nb_read;
+}
+
+ssize_t stream::read_until_impl(std::string& data, char delimiter, int timeout_ms) {
+  std::size_t nb_appended = 0;
+  std::size_t scanned = 0;  // Bytes known not to contain the delimiter
+  for (;;) {
+    char const* begin = read_buffer_.get() + read_begin_;
+    auto found = static_cast<char const*>(
+        std::memchr(begin + scanned, delimiter, buffered() - scanned));
+    if (found) {
+      std::size_t nb_bytes = found - begin + 1;
+      data.append(begin, nb_bytes);
+      read_begin_ += nb_bytes;
+      return nb_appended + nb_bytes;
+    }
+    if (buffered() == read_capacity_) {
+      // The buffer is full, move its content out to make room
+      data.append(begin, buffered());
+      nb_appended += buffered();
+      read_begin_ = read_end_;
+    }
+    scanned = buffered();
+    ssize_t rc = fill(timeout_ms);
+    if (rc < 0) return -1;
+    if (0 == rc) {
+      // End of file, give what is left
+      std::size_t nb_bytes = buffered();
+      data.append(read_buffer_.get() + read_begin_, nb_bytes);
+      read_begin_ = read_end_;
+      return nb_appended + nb_bytes;
+    }
+  }
+}
+
+ssize_t stream::peek_impl(char const*& data, std::size_t count, int timeout_ms) {
+  count = std::min(count, read_capacity_);
+  while (buffered() < count) {
+    ssize_t rc = fill(timeout_ms);
+    if (rc < 0) return -1;
+    if (0 == rc) break;
+  }
+  data = read_buffer_.get() + read_begin_;
+  return buffered();
+}
+
+void stream::consume(std::size_t count) {
+  read_begin_ += std::min(count, buffered());
+}
+
+ssize_t stream::write_impl(void const* buffer, std::size_t count, int timeout_ms) {
+  if (write_size_ + count < write_capacity_) {
+    std::memcpy(write_buffer_.get() + write_size_, buffer, count);
+    write_size_ += count;
+    return count;
+  }
+  // Overflow : write everything at once
+  iovec iov[2] = {{write_buffer_.get(), write_size_}, {const_cast<void*>(buffer), count}};
+  if (write_all(socket_, iov, 2, timeout_ms) < 0) {
+    // Keep what has not been written from the buffer
+    std::size_t nb_written = write_size_ - iov[0].iov_len;
+    if (0 < iov[0].iov_len)
+      std::memmove(write_buffer_.get(), write_buffer_.get() + nb_written, iov[0].iov_len);
+    write_size_ = iov[0].iov_len;
+    return -1;
+  }
+  write_size_ = 0;
+  return count;
+}
+
+ssize_t stream::flush_impl(int timeout_ms) {
+  if (0 == write_size_) return 0;
+  iovec iov{write_buffer_.get(), write_size_};
+  ssize_t rc = write_all(socket_, &iov, 1, timeout_ms);
+  if (0 < iov.iov_len && iov.iov_len < write_size_)
+    std::memmove(write_buffer_.get(), iov.iov_base, iov.iov_len);
+  write_size_ = rc < 0 ? iov.iov_len : 0;
+  return rc;
+}
+
+ssize_t stream::read(void* buffer, std::size_t count) {
+  return read_impl(buffer, count, -1);
+}
+
+ssize_t stream::read(void* buffer, std::size_t count, std::chrono::milliseconds const& timeout) {
+  return read_impl(buffer, count, static_cast<int>(timeout.count()));
+}
+
+ssize_t stream::read_exact(void* buffer, std::size_t count) {
+  return read_exact_impl(buffer, count, -1);
+}
+
+ssize_t stream::read_exact(void* buffer, std::size_t count,
+                           std::chrono::milliseconds const& timeout) {
+  return read_exact_impl(buffer, count, static_cast<int>(timeout.count()));
+}
+
+ssize_t stream::read_until(std::string& data, char delimiter) {
+  return read_until_impl(data, delimiter, -1);
+}
+
+ssize_t stream::read_until(std::string& data, char delimiter,
+                           std::chrono::milliseconds const& timeout) {
+  return read_until_impl(data, delimiter, static_cast<int>(timeout.count()));
+}
+
+ssize_t stream::peek(char const*& data, std::size_t count) {
+  return peek_impl(data, count, -1);
+}
+
+ssize_t stream::peek(char const*& data, std::size_t count,
+                     std::chrono::milliseconds const& timeout) {
+  return peek_impl(data, count, static_cast<int>(timeout.count()));
+}
+
+ssize_t stream::write(void const* buffer, std::size_t count) {
+  return write_impl(buffer, count, -1);
+}
+
+ssize_t stream::write(void const* buffer, std::size_t count,
+                      std::chrono::milliseconds const& timeout) {
+  return write_impl(buffer, count, static_cast<int>(timeout.count()));
+}
+
+ssize_t stream::flush() {
+  return flush_impl(-1);
+}
+
+ssize_t stream::flush(std::chrono::milliseconds const& timeout) {
+  return flush_impl(static_cast<int>(timeout.count()));
+}
+
+}  // namespace net
+}  // namespace boson
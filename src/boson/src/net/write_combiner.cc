@@ -0,0 +1,179 @@
+#include "boson/net/write_combiner.h"
+#include <sys/uio.h>
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstddef>
+#include <vector>
+#include "boson/routine_local.h"
+#include "boson/semaphore.h"
+#include "boson/syscalls.h"
+
+namespace boson {
+namespace net {
+
+namespace {
+
+struct pending_write {
+  void const* buffer;
+  std::size_t count;
+  shared_semaphore done;
+  pending_write* next = nullptr;
+  ssize_t result = 0;
+  int error = 0;
+  bool must_flush = false;  // Set when the flusher hands its role over
+
+  pending_write(void const* new_buffer, std::size_t new_count, shared_semaphore new_done)
+      : buffer{new_buffer}, count{new_count}, done{std::move(new_done)} {
+  }
+};
+
+// Each routine waits for its writes on its own semaphore, created once
+struct write_waiter {
+  shared_semaphore done{0};
+};
+
+routine_local<write_waiter> local_waiter;
+
+// Entries may be destroyed as soon as they are posted, so their semaphore is
+// kept alive by a copy while posting
+void wake_up(pending_write* entry) {
+  shared_semaphore done = entry->done;
+  done.post();
+}
+
+}  // namespace
+
+/**
+ * Writers are pushed on a lock free stack, which only the flusher empties
+ *
+ * Writers count themselves after pushing their entry: the one finding the
+ * count at zero is the flusher. The flusher may write entries not counted
+ * yet, so the count goes below zero until their writers count themselves,
+ * one of them then taking the role. A flusher finding more writers counted
+ * than it flushed knows their entries are already pushed, it hands its role
+ * over to the oldest of them. Entries are never popped one by one, so the
+ * stack has no ABA problem.
+ */
+struct write_combiner::impl {
+  fd_t fd;
+  std::atomic<pending_write*> pending{nullptr};
+  std::atomic<std::ptrdiff_t> nb_writers{0};
+
+  // Only used by the flusher, entries handed over come first in the next batch
+  pending_write* carried = nullptr;
+  std::vector<pending_write*> batch;
+  std::vector<iovec> iov;
+
+  impl(fd_t new_fd) : fd{new_fd} {
+  }
+
+  void push(pending_write* entry);
+
+  // Appends a stack of entries to the batch, oldest first
+  void append(pending_write* stack);
+
+  // Writes the batch, returns 0 or -1 with errno set
+  int write_batch();
+
+  // Flushes the queue, then hands the flusher role over
+  void flush();
+};
+
+void write_combiner::impl::push(pending_write* entry) {
+  pending_write* head = pending.load(std::memory_order_relaxed);
+  do {
+    entry->next = head;
+  } while (!pending.compare_exchange_weak(head, entry, std::memory_order_release,
+                                          std::memory_order_relaxed));
+}
+
+void write_combiner::impl::append(pending_write* stack) {
+  std::size_t first = batch.size();
+  for (; stack; stack = stack->next) batch.push_back(stack);
+  std::reverse(batch.begin() + first, batch.end());
+}
+
+int write_combiner::impl::write_batch() {
+  iov.clear();
+  for (auto entry : batch)
+    if (0 < entry->count) iov.push_back(iovec{const_cast<void*>(entry->buffer), entry->count});
+
+  iovec* current = iov.data();
+  int remaining = iov.size();
+  while (0 < remaining) {
+    ssize_t rc = boson::writev(fd, current, std::min(remaining, IOV_MAX));
+    if (rc < 0) return -1;
+    std::size_t written = rc;
+    while (0 < remaining && current->iov_len <= written) {
+      written -= current->iov_len;
+      ++current;
+      --remaining;
+    }
+    if (0 < remaining) {
+      current->iov_base = static_cast<char*>(current->iov_base) + written;
+      current->iov_len -= written;
+    }
+  }
+  return 0;
+}
+
+void write_combiner::impl::flush() {
+  // Let the other routines of this thread append their writes first
+  boson::yield();
+
+  batch.clear();
+  append(carried);
+  append(pending.exchange(nullptr, std::memory_order_acquire));
+  carried = nullptr;
+
+  int rc = write_batch();
+  int error = rc < 0 ? errno : 0;
+  for (auto entry : batch) {
+    entry->result = rc < 0 ? -1 : static_cast<ssize_t>(entry->count);
+    entry->error = error;
+  }
+
+  // The role is still ours, no other flusher may touch the batch meanwhile
+  std::ptrdiff_t nb_flushed = batch.size();
+  for (auto entry : batch) wake_up(entry);
+
+  // Hand the role over to the first writer which came in the meantime
+  if (nb_flushed < nb_writers.fetch_sub(nb_flushed, std::memory_order_acq_rel)) {
+    // Writers push before counting, so the stack is not empty
+    carried = pending.exchange(nullptr, std::memory_order_acquire);
+    pending_write* next_flusher = carried;
+    while (next_flusher->next) next_flusher = next_flusher->next;
+    next_flusher->must_flush = true;
+    wake_up(next_flusher);
+  }
+}
+
+write_combiner::write_combiner(fd_t fd) : impl_{std::make_shared<impl>(fd)} {
+}
+
+ssize_t write_combiner::write(void const* buffer, std::size_t count) {
+  pending_write entry{buffer, count, local_waiter->done};
+  impl_->push(&entry);
+  // A flusher may have written our entry already, even if the role becomes ours
+  bool is_flusher = 0 == impl_->nb_writers.fetch_add(1, std::memory_order_acq_rel);
+
+  if (!is_flusher) {
+    entry.done.wait();
+    // Woken up to take the flusher role, our bytes are not written yet
+    if (entry.must_flush) {
+      impl_->flush();
+      entry.done.wait();
+    }
+  }
+  else {
+    impl_->flush();
+    entry.done.wait();
+  }
+
+  if (entry.result < 0) errno = entry.error;
+  return entry.result;
+}
+
+}  // namespace net
+}  // namespace boson
@@ -0,0 +1,94 @@
+#include "boson/net/zerocopy.h"
+#include <linux/errqueue.h>
+#include <netinet/in.h>
+#include <algorithm>
+#include <cerrno>
+#include "boson/syscalls.h"
+
+namespace boson {
+namespace net {
+
+namespace {
+
+// Extracts a zero-copy completion from an error queue message
+bool parse_completion(msghdr& message, zerocopy_completion& completion) {
+#ifdef SO_EE_ORIGIN_ZEROCOPY
+  for (cmsghdr* header = CMSG_FIRSTHDR(&message); header;
+       header = CMSG_NXTHDR(&message, header)) {
+    if ((header->cmsg_level == SOL_IP && header->cmsg_type == IP_RECVERR) ||
+        (header->cmsg_level == SOL_IPV6 && header->cmsg_type == IPV6_RECVERR)) {
+      auto error = reinterpret_cast<sock_extended_err*>(CMSG_DATA(header));
+      if (0 == error->ee_errno && SO_EE_ORIGIN_ZEROCOPY == error->ee_origin) {
+        completion.first = error->ee_info;
+        completion.last = error->ee_data;
+        completion.copied = error->ee_code & SO_EE_CODE_ZEROCOPY_COPIED;
+        return true;
+      }
+    }
+  }
+#endif
+  return false;
+}
+
+template <bool HasTimer>
+int wait_completions_impl(socket_t socket, zerocopy_completion* completions, size_t count,
+                          std::chrono::milliseconds const& timeout) {
+  using namespace std::chrono;
+  if (0 == count) return 0;
+  // Messages other than completions do not start the timeout over
+  auto deadline = high_resolution_clock::now() + timeout;
+  int nb_completions = 0;
+  bool first = true;
+  while (static_cast<size_t>(nb_completions) < count) {
+    char control[CMSG_SPACE(sizeof(sock_extended_err)) + CMSG_SPACE(sizeof(sockaddr_in6))];
+    msghdr message{};
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    ssize_t rc = 0;
+    if (first) {
+      // Only the first read may suspend
+      if (HasTimer) {
+        auto left = duration_cast<milliseconds>(deadline - high_resolution_clock::now());
+        rc = boson::recvmsg(socket, &message, MSG_ERRQUEUE, std::max(left, milliseconds{0}));
+      }
+      else {
+        rc = boson::recvmsg(socket, &message, MSG_ERRQUEUE);
+      }
+      first = false;
+    }
+    else {
+      rc = ::recvmsg(socket, &message, MSG_ERRQUEUE | MSG_DONTWAIT);
+    }
+    if (rc < 0) {
+      if (0 == nb_completions) return -1;
+      break;
+    }
+    if (parse_completion(message, completions[nb_completions])) ++nb_completions;
+    else if (0 == nb_completions) first = true;  // Not a completion, keep waiting
+  }
+  return nb_completions;
+}
+
+}  // namespace
+
+int enable_zerocopy(socket_t socket) {
+#ifdef SO_ZEROCOPY
+  int yes = 1;
+  return ::setsockopt(socket, SOL_SOCKET, SO_ZEROCOPY, &yes, sizeof(yes));
+#else
+  errno = ENOPROTOOPT;
+  return -1;
+#endif
+}
+
+int wait_zerocopy_completions(socket_t socket, zerocopy_completion* completions, size_t count) {
+  return wait_completions_impl<false>(socket, completions, count, std::chrono::milliseconds{0});
+}
+
+int wait_zerocopy_completions(socket_t socket, zerocopy_completion* completions, size_t count,
+                              std::chrono::milliseconds const& timeout) {
+  return wait_completions_impl<true>(socket, completions, count, timeout);
+}
+
+}  // namespace net
+}  // namespace boson
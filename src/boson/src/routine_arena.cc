@@ -0,0 +1,94 @@
+#include "boson/routine_arena.h"
+#include <algorithm>
+#include <new>
+#include <vector>
+#include "boson/routine_local.h"
+
+namespace boson {
+
+namespace {
+
+constexpr std::size_t max_pooled_chunks = 64;
+
+// Chunks use the same size, so that any of them can be reused
+struct chunk_pool {
+  std::vector<void*> chunks;
+
+  ~chunk_pool() {
+    for (void* chunk : chunks) ::operator delete(chunk);
+  }
+};
+
+/**
+ * Chunks released in the calling thread
+ *
+ * A thread_local is fine here since it is never used across a suspension.
+ */
+chunk_pool& local_pool() {
+  thread_local chunk_pool pool;
+  return pool;
+}
+
+// Room left for the header, keeping the max alignment
+constexpr std::size_t header_size = alignof(std::max_align_t);
+
+}  // namespace
+
+routine_arena::~routine_arena() {
+  release();
+}
+
+routine_arena& routine_arena::current() {
+  static routine_local<routine_arena> arena;
+  return arena.get();
+}
+
+void* routine_arena::allocate_slow(std::size_t size, std::size_t alignment) {
+  alignment = std::max(alignment, alignof(std::max_align_t));
+  if (chunk_size - header_size < size + alignment) {
+    // Large allocations get their own block
+    auto block = static_cast<chunk_header*>(::operator new(header_size + size + alignment));
+    block->next = large_blocks_;
+    large_blocks_ = block;
+    auto aligned = (reinterpret_cast<std::uintptr_t>(block) + header_size + alignment - 1) &
+                   ~(alignment - 1);
+    nb_bytes_ += size;
+    return reinterpret_cast<void*>(aligned);
+  }
+
+  auto& pool = local_pool();
+  void* memory = nullptr;
+  if (pool.chunks.empty()) {
+    memory = ::operator new(chunk_size);
+  } else {
+    memory = pool.chunks.back();
+    pool.chunks.pop_back();
+  }
+  auto chunk = static_cast<chunk_header*>(memory);
+  chunk->next = chunks_;
+  chunks_ = chunk;
+  position_ = static_cast<char*>(memory) + header_size;
+  end_ = static_cast<char*>(memory) + chunk_size;
+  return allocate(size, alignment);
+}
+
+void routine_arena::release() {
+  auto& pool = local_pool();
+  while (chunks_) {
+    chunk_header* next = chunks_->next;
+    if (pool.chunks.size() < max_pooled_chunks)
+      pool.chunks.push_back(chunks_);
+    else
+      ::operator delete(chunks_);
+    chunks_ = next;
+  }
+  while (large_blocks_) {
+    chunk_header* next = large_blocks_->next;
+    ::operator delete(large_blocks_);
+    large_blocks_ = next;
+  }
+  position_ = end_ = nullptr;
+  nb_bytes_ = 0;
+}
+
+}  // namespace boson
@@ -0,0 +1,61 @@
+#include "boson/selector.h"
+#include "boson/exception.h"
+#include "boson/internal/routine.h"
+#include "boson/internal/thread.h"
+
+namespace boson {
+
+void selector::erase(std::size_t index) {
+  entries_.erase(entries_.begin() + index);
+}
+
+void selector::clear() {
+  entries_.clear();
+}
+
+int selector::select() {
+  return select_impl(-1);
+}
+
+int selector::select(std::chrono::milliseconds const& timeout) {
+  return select_impl(static_cast<int>(timeout.count()));
+}
+
+int selector::select_impl(int timeout_ms) {
+  using namespace std::chrono;
+  std::size_t nb_entries = entries_.size();
+  if (0 == nb_entries && timeout_ms < 0)
+    throw boson::exception("boson::selector::select would wait forever on an empty set");
+
+  std::size_t start = 0;
+  if (0 < nb_entries) {
+    start = start_ % nb_entries;
+    start_ = start + 1;
+  }
+
+  internal::routine* current_routine = internal::current_thread()->running_routine();
+  current_routine->start_event_round();
+
+  // Event indexes in the round are ranks from start
+  for (std::size_t rank = 0; rank < nb_entries; ++rank) {
+    std::size_t index = (start + rank) % nb_entries;
+    if (entries_[index]->subscribe(current_routine)) {
+      current_routine->cancel_event_round();
+      entries_[index]->execute(current_routine->happened_type(), true);
+      return static_cast<int>(index);
+    }
+  }
+  if (0 <= timeout_ms) {
+    current_routine->add_timer(
+        time_point_cast<milliseconds>(high_resolution_clock::now() + milliseconds(timeout_ms)));
+  }
+  current_routine->commit_event_round();
+
+  std::size_t rank = current_routine->happened_index();
+  if (nb_entries <= rank) return -1;
+  std::size_t index = (start + rank) % nb_entries;
+  entries_[index]->execute(current_routine->happened_type(), false);
+  return static_cast<int>(index);
+}
+
+}  // namespace boson
@@ -1,4 +1,5 @@
 #include "boson/semaphore.h"
+#include <algorithm>
 #include <cassert>
 #include "boson/engine.h"
 #include "boson/logger.h"
@@ -8,7 +9,7 @@ using namespace std::chrono;
 namespace boson {
 
 semaphore::semaphore(int capacity)
-    : counter_{capacity} {
+    : state_{static_cast<std::uint64_t>(capacity + counter_bias)}, nb_gatherers_{0} {
 }
 
 semaphore::~semaphore() {
@@ -19,57 +20,79 @@ semaphore::~semaphore() {
 }
 
 bool semaphore::pop_a_waiter(internal::thread* current) {
-  using namespace internal;
-  int result = 1;
-  if(0 < result) {
-    waiting_unit_t waiter;
-    if (read(waiter)) {
-      thread* managing_thread = waiter.first;
-      managing_thread->push_command(
-          current->id(), std::make_unique<thread_command>(
-                             thread_command_type::schedule_waiting_routine,
-                             std::make_pair(this->shared_from_this(),waiter.second)));
-      return true;
-    }
-  }
+  waiting_unit_t waiter;
+  if (read(waiter)) wake_up(current, waiter);
   return true;
 }
 
+void semaphore::pop_waiters(internal::thread* current, int count) {
+  waiting_unit_t waiter;
+  for (; 0 < count && read(waiter); --count) wake_up(current, waiter);
+}
+
+void semaphore::wake_up(internal::thread* current, waiting_unit_t const& waiter) {
+  using namespace internal;
+  if (waiter.first == current && current->wake_up_semaphore_waiter(this, waiter.second)) return;
+  waiter.first->push_command(current->id(), std::make_unique<thread_command>(
+                                                thread_command_type::schedule_waiting_routine,
+                                                std::make_pair(self_, waiter.second)));
+}
+
 size_t semaphore::write(internal::thread* target, std::size_t index) {
-  std::lock_guard<std::mutex> guard(waiters_lock_);
-  return waiters_.write(waiting_unit_t{target, index});
+  // Enqueued first, so that a post seeing this waiter counted finds it
+  size_t waiter_index = waiters_.write(target, index);
+  if (0 <= counter_of(state_.fetch_add(one_waiter + 1))) pop_a_waiter(target);
+  return waiter_index;
 }
 
 bool semaphore::read(waiting_unit_t& waiter) {
-  std::lock_guard<std::mutex> guard(waiters_lock_);
-  return waiters_.read(waiter);
+  bool popped = waiters_.read(waiter);
+  if (popped) state_.fetch_sub(one_waiter, std::memory_order_relaxed);
+  return popped;
 }
 
 bool semaphore::free(size_t index) {
-  std::lock_guard<std::mutex> guard(waiters_lock_);
-  return waiters_.lazy_free(index);
+  // Waiters are tombstoned, the queue is never walked
+  bool freed = waiters_.cancel(index);
+  if (freed) state_.fetch_sub(one_waiter, std::memory_order_relaxed);
+  return freed;
+}
+
+std::shared_ptr<semaphore> semaphore::gatherers_gate() {
+  auto gate = std::atomic_load(&gatherers_gate_);
+  if (!gate) {
+    auto new_gate = internal::make_semaphore(0);
+    // On failure, gate is the one another gatherer created
+    if (std::atomic_compare_exchange_strong(&gatherers_gate_, &gate, new_gate)) gate = new_gate;
+  }
+  return gate;
+}
+
+void semaphore::wake_up_gatherers() {
+  if (0 == nb_gatherers_.load()) return;
+  auto gate = std::atomic_exchange(&gatherers_gate_, std::shared_ptr<semaphore>{});
+  if (gate) gate->disable();
 }
 
 void semaphore::disable() {
   using namespace internal;
-  counter_.store(disabled_standpoint, std::memory_order_release);
+  // Waiters are still counted, their count is kept
+  std::uint64_t state = state_.load(std::memory_order_relaxed);
+  while (!state_.compare_exchange_weak(
+      state, (state & ~(one_waiter - 1)) + static_cast<std::uint64_t>(disabled_standpoint + counter_bias)))
+    ;
   waiting_unit_t waiter;
-  auto current_thread_id = current_thread()->id();
-  while (read(waiter)) {
-    thread* managing_thread = waiter.first;
-    managing_thread->push_command(
-        current_thread_id,
-        std::make_unique<thread_command>(thread_command_type::schedule_waiting_routine,
-                                         std::make_pair(this->shared_from_this(), waiter.second)));
-  }
+  thread* this_thread = current_thread();
+  while (read(waiter)) wake_up(this_thread, waiter);
+  wake_up_gatherers();
 }
 
 semaphore_result semaphore::wait(int timeout) {
   using namespace internal;
-  int result = counter_.fetch_sub(1,std::memory_order_acquire);
+  int result = take_ticket();
   event_type happened_type = event_type::sema_wait;
   if (disabling_threshold < result) {
-    counter_.fetch_add(1,std::memory_order_relaxed);
+    give_ticket_back();
     happened_type = event_type::sema_closed;
   }
   else if(result <= 0) {
@@ -94,15 +117,95 @@ semaphore_result semaphore::wait(int timeout) {
                                                          : semaphore_return_value::timedout};
 }
 
+semaphore_result semaphore::wait_n(int count, int timeout) {
+  // Fast path, everything is available
+  std::uint64_t state = state_.load(std::memory_order_relaxed);
+  while (count <= counter_of(state) && counter_of(state) <= disabling_threshold) {
+    if (state_.compare_exchange_weak(state, state - count, std::memory_order_acquire,
+                                     std::memory_order_relaxed))
+      return {semaphore_return_value::ok};
+  }
+
+  // Otherwise, wait until they are all there. Taking them one at a time
+  // would let two routines each hold some of them while waiting for more.
+  auto deadline = high_resolution_clock::now() + milliseconds(timeout);
+  nb_gatherers_.fetch_add(1);
+  state_.fetch_add(one_waiter);
+  semaphore_return_value result = semaphore_return_value::ok;
+  for (;;) {
+    // The gate is taken before checking, a post afterwards opens it
+    auto gate = gatherers_gate();
+    state = state_.load();
+    if (disabling_threshold < counter_of(state)) {
+      result = semaphore_return_value::disabled;
+      break;
+    }
+    if (count <= counter_of(state)) {
+      if (state_.compare_exchange_weak(state, state - count, std::memory_order_acquire,
+                                       std::memory_order_relaxed))
+        break;
+      continue;
+    }
+    int remaining = -1;
+    if (0 <= timeout) {
+      remaining = static_cast<int>(std::max<long long>(
+          0, duration_cast<milliseconds>(deadline - high_resolution_clock::now()).count()));
+    }
+    if (gate->wait(remaining) == semaphore_return_value::timedout) {
+      result = semaphore_return_value::timedout;
+      break;
+    }
+  }
+  state_.fetch_sub(one_waiter, std::memory_order_relaxed);
+  nb_gatherers_.fetch_sub(1);
+  return {result};
+}
+
+int semaphore::try_wait(int count) {
+  std::uint64_t state = state_.load(std::memory_order_relaxed);
+  while (0 < counter_of(state) && counter_of(state) <= disabling_threshold) {
+    int taken = std::min(count, counter_of(state));
+    if (state_.compare_exchange_weak(state, state - taken, std::memory_order_acquire,
+                                     std::memory_order_relaxed))
+      return taken;
+  }
+  return 0;
+}
+
+semaphore_result semaphore::post(int count) {
+  using namespace internal;
+  std::uint64_t state = state_.fetch_add(count);
+  int result = counter_of(state);
+  if (disabling_threshold < result) {
+    state_.fetch_sub(count, std::memory_order_relaxed);
+    return {semaphore_return_value::disabled};
+  }
+  // As in post(), one waiter per ticket is woken up unless the counter is
+  // negative, the routines in the middle of a wait then pop themselves
+  int nb_to_pop = std::min(count, result + count);
+  if (0 < nb_to_pop && 0 < nb_waiters_of(state)) {
+    wake_up_gatherers();
+    pop_waiters(internal::current_thread(), nb_to_pop);
+  }
+  return {semaphore_return_value::ok};
+}
+
 semaphore_result semaphore::post() {
   using namespace internal;
-  int result = counter_.fetch_add(1,std::memory_order_release);
+  std::uint64_t state = state_.fetch_add(1);
+  int result = counter_of(state);
   if (disabling_threshold < result) {
-    counter_.fetch_sub(1,std::memory_order_relaxed);
+    state_.fetch_sub(1,std::memory_order_relaxed);
     return {semaphore_return_value::disabled};
   }
-  else if(0 <= result) {
+  else if(0 <= result && 0 < nb_waiters_of(state)) {
+    wake_up_gatherers();
     // We may not gotten in the middle of a wait, so we cant avoid to try a pop
+    //
+    // A waiter enqueues itself, then counts itself and gives its counter
+    // decrement back in one increment, popping a waiter itself if the counter
+    // allows it. So if no waiter is counted before our increment, no one
+    // needs to be woken up.
     pop_a_waiter(internal::current_thread());
   }
   // We do not yield, this is the wait purpose
@@ -0,0 +1,64 @@
+#include "boson/shared_mutex.h"
+#include <algorithm>
+
+using namespace std::chrono;
+
+namespace boson {
+
+namespace {
+
+// Milliseconds left before the deadline, negative meaning no timeout
+inline int remaining_ms(int timeout, high_resolution_clock::time_point const& deadline) {
+  if (timeout < 0) return -1;
+  return static_cast<int>(std::max<long long>(
+      0, duration_cast<milliseconds>(deadline - high_resolution_clock::now()).count()));
+}
+
+}  // namespace
+
+shared_mutex::shared_mutex() : impl_{std::make_shared<internal::shared_mutex_state>()} {
+  impl_->readers_.set_owner(impl_);
+  impl_->writers_.set_owner(impl_);
+}
+
+semaphore_result shared_mutex::lock(int timeout) {
+  auto deadline = high_resolution_clock::now() + milliseconds(timeout);
+  impl_->nb_writers_.fetch_add(1, std::memory_order_acq_rel);
+  auto result = impl_->writers_.wait(timeout);
+  if (!result) {
+    impl_->nb_writers_.fetch_sub(1, std::memory_order_acq_rel);
+    return result;
+  }
+
+  // Every reader must leave first, new ones wait for us on writers_
+  result = impl_->readers_.wait_n(internal::shared_mutex_state::max_readers,
+                                  remaining_ms(timeout, deadline));
+  if (!result) {
+    impl_->nb_writers_.fetch_sub(1, std::memory_order_acq_rel);
+    impl_->writers_.post();
+  }
+  return result;
+}
+
+void shared_mutex::unlock() {
+  impl_->nb_writers_.fetch_sub(1, std::memory_order_acq_rel);
+  impl_->readers_.post(internal::shared_mutex_state::max_readers);
+  impl_->writers_.post();
+}
+
+semaphore_result shared_mutex::lock_shared(int timeout) {
+  auto deadline = high_resolution_clock::now() + milliseconds(timeout);
+  if (0 < impl_->nb_writers_.load(std::memory_order_acquire)) {
+    // Let the writers go first
+    auto result = impl_->writers_.wait(timeout);
+    if (!result) return result;
+    impl_->writers_.post();
+  }
+  return impl_->readers_.wait(remaining_ms(timeout, deadline));
+}
+
+void shared_mutex::unlock_shared() {
+  impl_->readers_.post();
+}
+
+}  // namespace boson
@@ -5,6 +5,7 @@
 #include "boson/syscall_traits.h"
 #include "boson/engine.h"
 #include "boson/std/experimental/chrono.h"
+#include <poll.h>
 
 namespace boson {
 
@@ -19,6 +20,24 @@ void yield() {
   current_routine->status_ = routine_status::running;
 }
 
+void migrate_to(std::size_t thread_id) {
+  thread* this_thread = current_thread();
+  if (thread_id == this_thread->id()) return;
+  if (this_thread->get_engine().max_nb_cores() <= thread_id)
+    throw boson::exception("boson::migrate_to: no such thread");
+  routine* current_routine = this_thread->running_routine();
+  // Slots of this thread still reference the event pointer, it must be
+  // released here since its reference count is not thread safe
+  current_routine->current_ptr_ = nullptr;
+  current_routine->migration_target_ = thread_id;
+  current_routine->status_ = routine_status::migrating;
+  // Resumed by the target thread, which must get the context back
+  transfer_t context = jump_fcontext(this_thread->context().fctx, nullptr);
+  current_thread()->context() = context;
+  current_routine->previous_status_ = routine_status::yielding;
+  current_routine->status_ = routine_status::running;
+}
+
 void nanosleep(std::chrono::nanoseconds duration) {
   using namespace std::chrono;
   usleep(duration_cast<microseconds>(duration));
@@ -133,19 +152,103 @@ ssize_t write(fd_t fd, const void *buf, size_t count) {
   return boson_classic_syscall<SYS_write>::call<false>(fd, -1, buf,count);
 }
 
+ssize_t readv(fd_t fd, const iovec *iov, int iovcnt) {
+  return boson_classic_syscall<SYS_readv>::call<false>(fd, -1, iov, iovcnt);
+}
+
+ssize_t writev(fd_t fd, const iovec *iov, int iovcnt) {
+  return boson_classic_syscall<SYS_writev>::call<false>(fd, -1, iov, iovcnt);
+}
+
+/**
+ * Suspends until the blocking end of a two fds transfer is ready
+ *
+ * When a transfer between two fds fails with EAGAIN, there is no telling which
+ * one blocked. A non blocking poll tells it, then we wait on that one until
+ * the deadline of the whole transfer.
+ */
 template <bool HasTimer>
-socket_t accept_impl(socket_t socket, sockaddr *address, socklen_t *address_len, int timout_ms) {
-  socket_t new_socket = boson_classic_syscall<SYS_accept>::call<HasTimer>(socket, timout_ms, address, address_len);
-  if (0 <= new_socket) {
-    ::fcntl(new_socket, F_SETFL, ::fcntl(new_socket, F_GETFD) | O_NONBLOCK);
+int wait_transfer_readiness(fd_t fd_in, fd_t fd_out,
+                            std::chrono::high_resolution_clock::time_point deadline) {
+  using namespace std::chrono;
+  int timeout_ms = -1;
+  if (HasTimer) {
+    auto left = duration_cast<milliseconds>(deadline - high_resolution_clock::now()).count();
+    timeout_ms = 0 < left ? static_cast<int>(left) : 0;
+  }
+  pollfd fds[2] = {{fd_in, POLLIN, 0}, {fd_out, POLLOUT, 0}};
+  ::poll(fds, 2, 0);
+  if (!(fds[0].revents & (POLLIN | POLLHUP | POLLERR | POLLNVAL)))
+    return wait_readiness<true, HasTimer>(fd_in, timeout_ms);
+  if (!(fds[1].revents & (POLLOUT | POLLHUP | POLLERR | POLLNVAL)))
+    return wait_readiness<false, HasTimer>(fd_out, timeout_ms);
+  // Both ends look ready, let others run before trying again
+  yield();
+  if (HasTimer && deadline <= high_resolution_clock::now()) {
+    errno = ETIMEDOUT;
+    return -1;
+  }
+  return 0;
+}
+
+template <int SyscallId> struct boson_transfer_syscall {
+  template <bool HasTimer, class... Args>
+  static inline decltype(auto) call(fd_t fd_in, fd_t fd_out, int timeout_ms, Args&&... args) {
+    using namespace std::chrono;
+    // Retries share the timeout instead of starting it over
+    high_resolution_clock::time_point deadline{};
+    if (HasTimer) deadline = high_resolution_clock::now() + milliseconds(timeout_ms);
+    auto return_code = syscall_callable<SyscallId>::call(std::forward<Args>(args)...);
+    while (return_code < 0 && (EAGAIN == errno || EWOULDBLOCK == errno)) {
+      return_code = wait_transfer_readiness<HasTimer>(fd_in, fd_out, deadline);
+      if (0 == return_code) {
+        return_code = syscall_callable<SyscallId>::call(std::forward<Args>(args)...);
+      }
+    }
+    return return_code;
   }
-  return new_socket;
+};
+
+ssize_t sendfile(fd_t out_fd, fd_t in_fd, off_t *offset, size_t count) {
+  return boson_transfer_syscall<SYS_sendfile>::call<false>(in_fd, out_fd, -1, out_fd, in_fd,
+                                                           offset, count);
+}
+
+ssize_t splice(fd_t fd_in, loff_t *off_in, fd_t fd_out, loff_t *off_out, size_t length,
+               unsigned int flags) {
+  return boson_transfer_syscall<SYS_splice>::call<false>(
+      fd_in, fd_out, -1, fd_in, off_in, fd_out, off_out, length, flags | SPLICE_F_NONBLOCK);
+}
+
+ssize_t tee(fd_t fd_in, fd_t fd_out, size_t length, unsigned int flags) {
+  return boson_transfer_syscall<SYS_tee>::call<false>(fd_in, fd_out, -1, fd_in, fd_out, length,
+                                                      flags | SPLICE_F_NONBLOCK);
+}
+
+template <bool HasTimer>
+socket_t accept_impl(socket_t socket, sockaddr *address, socklen_t *address_len, int timout_ms) {
+  return boson_classic_syscall<SYS_accept4>::call<HasTimer>(socket, timout_ms, address,
+                                                            address_len, accepted_socket_flags);
 }
 
 socket_t accept(socket_t socket, sockaddr *address, socklen_t *address_len) {
   return accept_impl<false>(socket, address, address_len, -1);
 }
 
+template <bool HasTimer>
+ssize_t accept_many_impl(socket_t socket, socket_t *sockets, size_t count, int timeout_ms) {
+  if (0 == count) return 0;
+  // Suspend until the first connection, then drain the backlog without suspending
+  socket_t new_socket = accept_impl<HasTimer>(socket, nullptr, nullptr, timeout_ms);
+  if (new_socket < 0) return -1;
+  sockets[0] = new_socket;
+  return 1 + drain_accept_backlog(socket, sockets + 1, count - 1);
+}
+
+ssize_t accept_many(socket_t socket, socket_t *sockets, size_t count) {
+  return accept_many_impl<false>(socket, sockets, count, -1);
+}
+
 ssize_t send(socket_t socket, const void *buffer, size_t length, int flags) {
   return boson_classic_syscall<SYS_sendto>::call<false>(socket, -1, buffer, length, flags, nullptr, nullptr);
 }
@@ -154,6 +257,33 @@ ssize_t recv(socket_t socket, void *buffer, size_t length, int flags) {
   return boson_classic_syscall<SYS_recvfrom>::call<false>(socket, -1, buffer, length, flags, nullptr, nullptr);
 }
 
+ssize_t sendto(socket_t socket, const void *buffer, size_t length, int flags,
+               const sockaddr *address, socklen_t address_len) {
+  return boson_classic_syscall<SYS_sendto>::call<false>(socket, -1, buffer, length, flags, address, address_len);
+}
+
+ssize_t recvfrom(socket_t socket, void *buffer, size_t length, int flags, sockaddr *address,
+                 socklen_t *address_len) {
+  return boson_classic_syscall<SYS_recvfrom>::call<false>(socket, -1, buffer, length, flags, address, address_len);
+}
+
+ssize_t sendmsg(socket_t socket, const msghdr *message, int flags) {
+  return boson_classic_syscall<SYS_sendmsg>::call<false>(socket, -1, message, flags);
+}
+
+ssize_t recvmsg(socket_t socket, msghdr *message, int flags) {
+  return boson_classic_syscall<SYS_recvmsg>::call<false>(socket, -1, message, flags);
+}
+
+int sendmmsg(socket_t socket, mmsghdr *messages, unsigned int count, int flags) {
+  return boson_classic_syscall<SYS_sendmmsg>::call<false>(socket, -1, messages, count, flags);
+}
+
+int recvmmsg(socket_t socket, mmsghdr *messages, unsigned int count, int flags) {
+  return boson_classic_syscall<SYS_recvmmsg>::call<false>(socket, -1, messages, count, flags,
+                                                          nullptr);
+}
+
 ssize_t read(fd_t fd, void* buf, size_t count, std::chrono::milliseconds const& timeout_ms) {
   return boson_classic_syscall<SYS_read>::call<true>(fd, static_cast<int>(timeout_ms.count()), buf,count);
 }
@@ -162,10 +292,34 @@ ssize_t write(fd_t fd, const void* buf, size_t count, std::chrono::milliseconds
   return boson_classic_syscall<SYS_write>::call<true>(fd, static_cast<int>(timeout_ms.count()), buf,count);
 }
 
+ssize_t readv(fd_t fd, const iovec* iov, int iovcnt, std::chrono::milliseconds const& timeout_ms) {
+  return boson_classic_syscall<SYS_readv>::call<true>(fd, static_cast<int>(timeout_ms.count()), iov, iovcnt);
+}
+
+ssize_t writev(fd_t fd, const iovec* iov, int iovcnt, std::chrono::milliseconds const& timeout_ms) {
+  return boson_classic_syscall<SYS_writev>::call<true>(fd, static_cast<int>(timeout_ms.count()), iov, iovcnt);
+}
+
+ssize_t sendfile(fd_t out_fd, fd_t in_fd, off_t* offset, size_t count, std::chrono::milliseconds const& timeout_ms) {
+  return boson_transfer_syscall<SYS_sendfile>::call<true>(in_fd, out_fd, static_cast<int>(timeout_ms.count()), out_fd, in_fd, offset, count);
+}
+
+ssize_t splice(fd_t fd_in, loff_t* off_in, fd_t fd_out, loff_t* off_out, size_t length, unsigned int flags, std::chrono::milliseconds const& timeout_ms) {
+  return boson_transfer_syscall<SYS_splice>::call<true>(fd_in, fd_out, static_cast<int>(timeout_ms.count()), fd_in, off_in, fd_out, off_out, length, flags | SPLICE_F_NONBLOCK);
+}
+
+ssize_t tee(fd_t fd_in, fd_t fd_out, size_t length, unsigned int flags, std::chrono::milliseconds const& timeout_ms) {
+  return boson_transfer_syscall<SYS_tee>::call<true>(fd_in, fd_out, static_cast<int>(timeout_ms.count()), fd_in, fd_out, length, flags | SPLICE_F_NONBLOCK);
+}
+
 socket_t accept(socket_t socket, sockaddr* address, socklen_t* address_len, std::chrono::milliseconds const& timeout_ms) {
   return accept_impl<true>(socket, address, address_len, static_cast<int>(timeout_ms.count()));
 }
 
+ssize_t accept_many(socket_t socket, socket_t* sockets, size_t count, std::chrono::milliseconds const& timeout_ms) {
+  return accept_many_impl<true>(socket, sockets, count, static_cast<int>(timeout_ms.count()));
+}
+
 ssize_t send(socket_t socket, const void* buffer, size_t length, int flags, std::chrono::milliseconds const& timeout_ms) {
   return boson_classic_syscall<SYS_sendto>::call<true>(socket, static_cast<int>(timeout_ms.count()), buffer, length, flags, nullptr, nullptr);
 }
@@ -174,6 +328,30 @@ ssize_t recv(socket_t socket, void* buffer, size_t length, int flags, std::chron
   return boson_classic_syscall<SYS_recvfrom>::call<true>(socket, static_cast<int>(timeout_ms.count()), buffer, length, flags, nullptr, nullptr);
 }
 
+ssize_t sendto(socket_t socket, const void* buffer, size_t length, int flags, const sockaddr* address, socklen_t address_len, std::chrono::milliseconds const& timeout_ms) {
+  return boson_classic_syscall<SYS_sendto>::call<true>(socket, static_cast<int>(timeout_ms.count()), buffer, length, flags, address, address_len);
+}
+
+ssize_t recvfrom(socket_t socket, void* buffer, size_t length, int flags, sockaddr* address, socklen_t* address_len, std::chrono::milliseconds const& timeout_ms) {
+  return boson_classic_syscall<SYS_recvfrom>::call<true>(socket, static_cast<int>(timeout_ms.count()), buffer, length, flags, address, address_len);
+}
+
+ssize_t sendmsg(socket_t socket, const msghdr* message, int flags, std::chrono::milliseconds const& timeout_ms) {
+  return boson_classic_syscall<SYS_sendmsg>::call<true>(socket, static_cast<int>(timeout_ms.count()), message, flags);
+}
+
+ssize_t recvmsg(socket_t socket, msghdr* message, int flags, std::chrono::milliseconds const& timeout_ms) {
+  return boson_classic_syscall<SYS_recvmsg>::call<true>(socket, static_cast<int>(timeout_ms.count()), message, flags);
+}
+
+int sendmmsg(socket_t socket, mmsghdr* messages, unsigned int count, int flags, std::chrono::milliseconds const& timeout_ms) {
+  return boson_classic_syscall<SYS_sendmmsg>::call<true>(socket, static_cast<int>(timeout_ms.count()), messages, count, flags);
+}
+
+int recvmmsg(socket_t socket, mmsghdr* messages, unsigned int count, int flags, std::chrono::milliseconds const& timeout_ms) {
+  return boson_classic_syscall<SYS_recvmmsg>::call<true>(socket, static_cast<int>(timeout_ms.count()), messages, count, flags, nullptr);
+}
+
 template <bool HasTimer> inline int connect_impl(socket_t sockfd, const sockaddr* addr, socklen_t addrlen, int timeout_ms) {
   int return_code = syscall_callable<SYS_connect>::call(sockfd, addr, addrlen);
   if (return_code < 0 && errno == EINPROGRESS) {
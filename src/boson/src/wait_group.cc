@@ -0,0 +1,24 @@
+#include "boson/wait_group.h"
+#include "boson/exception.h"
+
+namespace boson {
+
+void wait_group::add(int delta) {
+  int count = impl_->count_.fetch_add(delta) + delta;
+  if (count < 0) throw boson::exception("boson::wait_group counter is negative");
+  if (0 == count && delta < 0) {
+    // Waiters hold the old gate, new ones will wait for the next zero
+    std::atomic_exchange(&impl_->gate_, internal::make_semaphore(0))->disable();
+  }
+}
+
+semaphore_result wait_group::wait(int timeout) {
+  // The gate must be read first, the counter reaching zero afterwards disables it
+  auto gate = std::atomic_load(&impl_->gate_);
+  if (0 == impl_->count_.load()) return {semaphore_return_value::ok};
+  auto result = gate->wait(timeout);
+  return {result == semaphore_return_value::timedout ? semaphore_return_value::timedout
+                                                     : semaphore_return_value::ok};
+}
+
+}  // namespace boson
@@ -0,0 +1,69 @@
+#include "catch.hpp"
+#include "boson/boson.h"
+#include <atomic>
+#include "boson/barrier.h"
+#include "boson/select.h"
+
+using namespace boson;
+using namespace std::literals;
+
+namespace {
+inline int time_factor() {
+#ifdef BOSON_USE_VALGRIND
+  return RUNNING_ON_VALGRIND ? 10 : 1;
+#else
+  return 1;
+#endif
+}
+}
+
+TEST_CASE("Barrier", "[barrier]") {
+  SECTION("Phases") {
+    constexpr int nb_routines = 8;
+    constexpr int nb_phases = 100;
+    std::atomic<int> nb_arrived{0};
+    std::atomic<int> nb_errors{0};
+    boson::run(4, [&]() {
+      barrier sync(nb_routines);
+      for (int index = 0; index < nb_routines; ++index) {
+        start([&](auto sync) -> void {
+          for (int phase = 0; phase < nb_phases; ++phase) {
+            nb_arrived.fetch_add(1);
+            sync.arrive_and_wait();
+            if (nb_arrived.load() < (phase + 1) * nb_routines) ++nb_errors;
+            sync.arrive_and_wait();
+          }
+        }, sync);
+      }
+    });
+    CHECK(nb_errors == 0);
+    CHECK(nb_arrived == nb_routines * nb_phases);
+  }
+
+  SECTION("Timeout") {
+    boson::run(1, [&]() {
+      barrier sync(2);
+      auto token = sync.arrive();
+      CHECK(sync.wait(token, time_factor() * 5ms) == semaphore_return_value::timedout);
+      sync.arrive();
+      CHECK(sync.wait(token));
+    });
+  }
+
+  SECTION("Select") {
+    boson::run(1, [&]() {
+      barrier sync(2);
+      start([](auto sync) -> void {
+        auto token = sync.arrive();
+        int result = select_any(event_wait(token, []() { return 1; }),
+                                event_timer(time_factor() * 5ms, []() { return 2; }));
+        CHECK(result == 2);
+        result = select_any(event_wait(token, []() { return 1; }),
+                            event_timer(time_factor() * 100ms, []() { return 2; }));
+        CHECK(result == 1);
+      }, sync);
+      boson::sleep(time_factor() * 10ms);
+      sync.arrive_and_wait();
+    });
+  }
+}
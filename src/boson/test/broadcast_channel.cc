@@ -0,0 +1,134 @@
+#include "catch.hpp"
+#include "boson/boson.h"
+#include "boson/broadcast_channel.h"
+#include <iostream>
+#include "boson/logger.h"
+
+using namespace boson;
+using namespace std::literals;
+
+namespace {
+inline int time_factor() {
+#ifdef BOSON_USE_VALGRIND
+  return RUNNING_ON_VALGRIND ? 10 : 1;
+#else
+  return 1;
+#endif
+}
+}
+
+static constexpr int nb_iter = 1000;
+
+TEST_CASE("Broadcast channels", "[channels][broadcast]") {
+  boson::debug::logger_instance(&std::cout);
+
+  SECTION("Every subscriber gets every element") {
+    constexpr int nb_subscribers = 3;
+    std::vector<std::vector<int>> received(nb_subscribers);
+    std::vector<int const*> addresses(nb_subscribers, nullptr);
+    boson::run(nb_subscribers + 1, [&]() {
+      broadcast_channel<int> chan(nb_iter);
+      for (int index = 0; index < nb_subscribers; ++index) {
+        start_explicit(index + 1,
+                       [&received, &addresses](int index, auto in) -> void {
+                         std::shared_ptr<int const> value;
+                         while (in >> value) {
+                           if (0 == *value) addresses[index] = value.get();
+                           received[index].push_back(*value);
+                         }
+                       },
+                       index, chan.subscribe());
+      }
+      for (int index = 0; index < nb_iter; ++index) CHECK(chan << index);
+      chan.close();
+      CHECK_FALSE(chan << 0);
+    });
+    std::vector<int> expected(nb_iter, 0);
+    for (int index = 0; index < nb_iter; ++index) expected[index] = index;
+    for (auto& values : received) CHECK(values == expected);
+    // The element is shared, not copied
+    CHECK(addresses[0] == addresses[1]);
+    CHECK(addresses[1] == addresses[2]);
+  }
+
+  SECTION("Lagging subscribers") {
+    boson::run(1, [&]() {
+      broadcast_channel<int> skipping(2);
+      broadcast_channel<int> dropping(2, broadcast_lag_policy::drop);
+      auto skipper = skipping.subscribe();
+      auto dropped = dropping.subscribe();
+      for (int index = 0; index < 5; ++index) {
+        skipping << index;
+        dropping << index;
+      }
+      std::shared_ptr<int const> value;
+      CHECK(skipper.read(value));
+      CHECK(*value == 3);
+      CHECK(skipper.nb_lost() == 3);
+      CHECK(skipper.read(value));
+      CHECK(*value == 4);
+      CHECK(skipper.read(value, time_factor()) == channel_result_value::timedout);
+      CHECK(dropped.read(value) == channel_result_value::closed);
+      CHECK(dropped.dropped());
+      // A late subscriber starts with the next element
+      auto late = dropping.subscribe();
+      dropping << 5;
+      CHECK(late.read(value));
+      CHECK(*value == 5);
+    });
+  }
+
+  SECTION("Select") {
+    std::vector<int> received;
+    boson::run(2, [&]() {
+      broadcast_channel<int> chan(4);
+      auto in = chan.subscribe();
+      start_explicit(1,
+                     [](auto out) -> void {
+                       for (int index = 0; index < nb_iter; ++index) {
+                         out << index;
+                         boson::yield();
+                       }
+                       out.close();
+                     },
+                     chan);
+      std::shared_ptr<int const> value;
+      bool done = false;
+      while (!done) {
+        select_any(event_read(in, value,
+                              [&](bool success) {
+                                if (success)
+                                  received.push_back(*value);
+                                else
+                                  done = true;
+                              }),
+                   event_timer(1000ms * time_factor(), [&]() { done = true; }));
+      }
+      CHECK(!in.dropped());
+      CHECK(received.size() + in.nb_lost() == static_cast<std::size_t>(nb_iter));
+    });
+    CHECK(!received.empty());
+    CHECK(received.back() == nb_iter - 1);
+  }
+
+  SECTION("Lost selects leave nothing behind") {
+    boson::run(1, [&]() {
+      broadcast_channel<int> chan(4);
+      auto in = chan.subscribe();
+      std::shared_ptr<int const> value;
+      auto read_or_time_out = [&]() {
+        return select_any(event_read(in, value, [](bool) { return 1; }),
+                          event_timer(time_factor() * 5ms, []() { return 2; }));
+      };
+      CHECK(read_or_time_out() == 2);
+      chan << 1;
+      CHECK(in.read(value));
+      CHECK(*value == 1);
+      // Nothing to read, the timer must win
+      CHECK(read_or_time_out() == 2);
+      chan << 2;
+      CHECK(read_or_time_out() == 1);
+      CHECK(*value == 2);
+    });
+  }
+}
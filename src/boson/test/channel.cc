@@ -174,6 +174,290 @@ TEST_CASE("Channels", "[channels]") {
   CHECK(acks == expected);
 }
 
+TEST_CASE("Channels - Contended", "[channels]") {
+  boson::debug::logger_instance(&std::cout);
+  constexpr int nb_producers = 8;
+  constexpr int nb_values = 1000;
+
+  SECTION("Many producers and consumers on several threads") {
+    std::atomic<long> sum{0};
+    boson::run(4, [&]() {
+      channel<int, 1> values;
+      channel<std::nullptr_t, 1> done;
+      for (int producer = 0; producer < nb_producers; ++producer) {
+        start(
+            [](auto out) -> void {
+              for (int value = 1; value <= nb_values; ++value) out << value;
+            },
+            values);
+      }
+      for (int consumer = 0; consumer < nb_producers; ++consumer) {
+        start(
+            [&sum](auto in, auto done) -> void {
+              int value = 0;
+              for (int index = 0; index < nb_values; ++index) {
+                in >> value;
+                sum += value;
+              }
+              done << nullptr;
+            },
+            values, done);
+      }
+      std::nullptr_t dummy;
+      for (int consumer = 0; consumer < nb_producers; ++consumer) done >> dummy;
+    });
+    CHECK(sum == static_cast<long>(nb_producers) * nb_values * (nb_values + 1) / 2);
+  }
+
+  SECTION("Uncontended exchanges never suspend") {
+    bool other_ran = false;
+    boson::run(1, [&]() {
+      start([](bool* ran) -> void { *ran = true; }, &other_ran);
+      channel<int, 4> values;
+      int value = 0;
+      for (int round = 0; round < nb_values; ++round) {
+        for (int index = 0; index < 4; ++index) values << index;
+        for (int index = 0; index < 4; ++index) {
+          values >> value;
+          CHECK(value == index);
+        }
+      }
+      // Only a suspension could have let the other routine run
+      CHECK(!other_ran);
+    });
+    CHECK(other_ran);
+  }
+}
+
+TEST_CASE("Unbuffered channels", "[channels]") {
+  boson::debug::logger_instance(&std::cout);
+
+  SECTION("Writes wait for readers") {
+    std::atomic<int> nb_written{0};
+    std::vector<int> received;
+    boson::run(3, [&]() {
+      channel<int, 0> chan;
+      channel<std::nullptr_t, 0> done;
+      start(
+          [&](auto out) -> void {
+            for (int index = 0; index < nb_iter; ++index) {
+              out << index;
+              ++nb_written;
+            }
+          },
+          chan);
+      start(
+          [&](auto in, auto done) -> void {
+            int value = 0;
+            for (int index = 0; index < nb_iter; ++index) {
+              boson::sleep(1ms);
+              // The writer can not be ahead of us
+              CHECK(nb_written <= index);
+              in >> value;
+              received.push_back(value);
+            }
+            done << nullptr;
+          },
+          chan, done);
+      std::nullptr_t dummy;
+      done >> dummy;
+    });
+    std::vector<int> expected(nb_iter, 0);
+    for (int index = 0; index < nb_iter; ++index) expected[index] = index;
+    CHECK(received == expected);
+  }
+
+  SECTION("Many writers and readers") {
+    std::atomic<int> sum{0};
+    boson::run(3, [&]() {
+      channel<int, 0> chan;
+      channel<std::nullptr_t, 4> done;
+      for (int routine = 0; routine < 4; ++routine) {
+        start(
+            [](auto out) -> void {
+              for (int index = 0; index < nb_iter; ++index) out << 1;
+            },
+            chan);
+        start(
+            [&sum](auto in, auto done) -> void {
+              int value = 0;
+              for (int index = 0; index < nb_iter; ++index) {
+                // Timed out reads must not lose values
+                while (!in.read(value, index % 2)) {
+                }
+                sum += value;
+              }
+              done << nullptr;
+            },
+            chan, done);
+      }
+      std::nullptr_t dummy;
+      for (int routine = 0; routine < 4; ++routine) done >> dummy;
+    });
+    CHECK(sum == 4 * nb_iter);
+  }
+
+  SECTION("Timeouts and closing") {
+    boson::run(3, [&]() {
+      channel<int, 0> chan;
+      CHECK(chan.write(1, time_factor()) == channel_result_value::timedout);
+      int value = 0;
+      CHECK(chan.read(value, time_factor()) == channel_result_value::timedout);
+
+      channel<std::nullptr_t, 0> started;
+      start(
+          [](auto in, auto started) -> void {
+            int value = 0;
+            started << nullptr;
+            CHECK(in.read(value) == channel_result_value::closed);
+          },
+          chan, started);
+      std::nullptr_t dummy;
+      started >> dummy;
+      boson::sleep(1ms);
+      chan.close();
+      CHECK(chan.write(1) == channel_result_value::closed);
+      CHECK(chan.read(value) == channel_result_value::closed);
+    });
+  }
+
+  SECTION("Closing lets a waiting writer go") {
+    boson::run(2, [&]() {
+      channel<int, 0> chan;
+      channel<std::nullptr_t, 0> done;
+      start(
+          [](auto out, auto done) -> void {
+            CHECK(out.write(1) == channel_result_value::closed);
+            done << nullptr;
+          },
+          chan, done);
+      boson::sleep(time_factor() * 5ms);
+      chan.close();
+      std::nullptr_t dummy;
+      CHECK(done.read(dummy, time_factor() * 100));
+    });
+  }
+}
+
+TEST_CASE("Runtime sized channels", "[channels]") {
+  boson::debug::logger_instance(&std::cout);
+
+  SECTION("Capacity given at construction") {
+    boson::run(1, [&]() {
+      channel<int> chan(channel_size);
+      for (int index = 0; index < channel_size; ++index) CHECK(chan.write(index));
+      CHECK(chan.write(0, time_factor()) == channel_result_value::timedout);
+      int value = 0;
+      for (int index = 0; index < channel_size; ++index) {
+        CHECK(chan.read(value));
+        CHECK(index == value);
+      }
+      CHECK(chan.read(value, time_factor()) == channel_result_value::timedout);
+    });
+    // Unbuffered channels have their own implementation
+    CHECK_THROWS_AS(channel<int>(0), boson::exception);
+  }
+
+  SECTION("Unbounded channel") {
+    std::vector<std::size_t> high_waters;
+    boson::run(1, [&]() {
+      channel<int, unbounded_channel_size> chan(
+          channel_size, [&](std::size_t size) { high_waters.push_back(size); });
+      for (int index = 0; index < 10 * channel_size; ++index) CHECK(chan.write(index));
+      chan.close();
+      CHECK(chan.write(0) == channel_result_value::closed);
+
+      int value = 0;
+      for (int index = 0; index < 10 * channel_size; ++index) {
+        bool result = false;
+        select_any(event_read(chan, value, [&](bool ok) { result = ok; }));
+        CHECK(result);
+        CHECK(index == value);
+      }
+      CHECK(chan.read(value) == channel_result_value::closed);
+    });
+    CHECK(high_waters == std::vector<std::size_t>{channel_size});
+  }
+
+  SECTION("Unbounded channel across threads") {
+    std::vector<int> received;
+    boson::run(2, [&]() {
+      channel<int, unbounded_channel_size> chan;
+      start_explicit(1,
+                     [](auto out) -> void {
+                       for (int index = 0; index < nb_iter * channel_size; ++index)
+                         out << index;
+                       out.close();
+                     },
+                     chan);
+      int value = 0;
+      while (chan >> value) received.push_back(value);
+    });
+    std::vector<int> expected(nb_iter * channel_size, 0);
+    for (int index = 0; index < nb_iter * channel_size; ++index) expected[index] = index;
+    CHECK(received == expected);
+  }
+}
+
+TEST_CASE("Batched channel operations", "[channels]") {
+  boson::debug::logger_instance(&std::cout);
+  constexpr int nb_values = 1000;
+
+  SECTION("Buffered channel") {
+    std::vector<int> received;
+    boson::run(2, [&]() {
+      channel<int, 64> chan;
+      start_explicit(1,
+                     [](auto out) -> void {
+                       std::array<int, 16> values;
+                       int next = 0;
+                       while (next < nb_values) {
+                         std::size_t count = 0;
+                         for (; count < values.size() && next + count < nb_values; ++count)
+                           values[count] = next + count;
+                         // Writes what fits, the rest is resent
+                         CHECK(out.write_n(values.data(), count));
+                         next += count;
+                       }
+                       out.close();
+                     },
+                     chan);
+      std::array<int, 32> values;
+      std::size_t count = values.size();
+      while (chan.read_n(values.data(), count)) {
+        CHECK(0 < count);
+        received.insert(received.end(), values.begin(), values.begin() + count);
+        count = values.size();
+      }
+      CHECK(0 == count);
+    });
+    std::vector<int> expected(nb_values, 0);
+    for (int index = 0; index < nb_values; ++index) expected[index] = index;
+    CHECK(received == expected);
+  }
+
+  SECTION("Unbounded channel") {
+    boson::run(1, [&]() {
+      channel<int, unbounded_channel_size> chan;
+      std::array<int, 8> values{{0, 1, 2, 3, 4, 5, 6, 7}};
+      std::size_t count = values.size();
+      CHECK(chan.write_n(values.data(), count));
+      CHECK(count == values.size());
+
+      std::array<int, 5> first;
+      count = first.size();
+      CHECK(chan.read_n(first.data(), count));
+      CHECK(count == first.size());
+      CHECK(first[4] == 4);
+      count = first.size();
+      CHECK(chan.read_n(first.data(), count));
+      CHECK(count == 3);
+      CHECK(first[2] == 7);
+      CHECK(chan.read_n(first.data(), count, time_factor()) == channel_result_value::timedout);
+    });
+  }
+}
+
 TEST_CASE("Empty channels", "[channels]") {
   boson::debug::logger_instance(&std::cout);
   SECTION("Close an empty channel") {
@@ -0,0 +1,105 @@
+#include "catch.hpp"
+#include "boson/boson.h"
+#include <atomic>
+#include <deque>
+#include "boson/condition_variable.h"
+#include "boson/select.h"
+
+using namespace boson;
+using namespace std::literals;
+
+namespace {
+inline int time_factor() {
+#ifdef BOSON_USE_VALGRIND
+  return RUNNING_ON_VALGRIND ? 10 : 1;
+#else
+  return 1;
+#endif
+}
+}
+
+TEST_CASE("Condition variable", "[condition_variable]") {
+  SECTION("Producer and consumers") {
+    constexpr int nb_values = 10000;
+    std::atomic<int> nb_consumed{0};
+    std::deque<int> values;
+    bool finished = false;
+    boson::run(4, [&]() {
+      boson::mutex mut;
+      condition_variable cond;
+      for (int index = 0; index < 3; ++index) {
+        start([&](auto mut, auto cond) -> void {
+          mut.lock();
+          for (;;) {
+            cond.wait(mut, [&]() { return finished || !values.empty(); });
+            if (values.empty()) break;
+            values.pop_front();
+            nb_consumed.fetch_add(1);
+          }
+          mut.unlock();
+        }, mut, cond);
+      }
+      for (int index = 0; index < nb_values; ++index) {
+        mut.lock();
+        values.push_back(index);
+        mut.unlock();
+        cond.notify_one();
+        if (0 == index % 100) boson::yield();
+      }
+      mut.lock();
+      finished = true;
+      mut.unlock();
+      cond.notify_all();
+    });
+    CHECK(nb_consumed == nb_values);
+  }
+
+  SECTION("Notify all") {
+    int nb_woken = 0;
+    bool ready = false;
+    boson::run(1, [&]() {
+      boson::mutex mut;
+      condition_variable cond;
+      for (int index = 0; index < 10; ++index) {
+        start([&](auto mut, auto cond) -> void {
+          mut.lock();
+          cond.wait(mut, [&]() { return ready; });
+          ++nb_woken;
+          mut.unlock();
+        }, mut, cond);
+      }
+      boson::sleep(time_factor() * 5ms);
+      mut.lock();
+      ready = true;
+      mut.unlock();
+      cond.notify_all();
+    });
+    CHECK(nb_woken == 10);
+  }
+
+  SECTION("Timeout") {
+    boson::run(1, [&]() {
+      boson::mutex mut;
+      condition_variable cond;
+      mut.lock();
+      CHECK(cond.wait(mut, time_factor() * 5ms) == semaphore_return_value::timedout);
+      mut.unlock();
+    });
+  }
+
+  SECTION("Select") {
+    boson::run(1, [&]() {
+      condition_variable cond;
+      start([](auto cond) -> void {
+        int result = select_any(event_wait(cond, []() { return 1; }),
+                                event_timer(time_factor() * 5ms, []() { return 2; }));
+        CHECK(result == 2);
+        result = select_any(event_wait(cond, []() { return 1; }),
+                            event_timer(time_factor() * 100ms, []() { return 2; }));
+        CHECK(result == 1);
+      }, cond);
+      boson::sleep(time_factor() * 10ms);
+      cond.notify_one();
+    });
+  }
+}
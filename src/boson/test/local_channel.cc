@@ -0,0 +1,116 @@
+#include "catch.hpp"
+#include "boson/boson.h"
+#include "boson/local_channel.h"
+#include <iostream>
+#include "boson/logger.h"
+
+using namespace boson;
+using namespace std::literals;
+
+namespace {
+inline int time_factor() {
+#ifdef BOSON_USE_VALGRIND
+  return RUNNING_ON_VALGRIND ? 10 : 1;
+#else
+  return 1;
+#endif
+}
+}
+
+static constexpr int nb_iter = 1000;
+
+TEST_CASE("Local channels", "[channels][local]") {
+  boson::debug::logger_instance(&std::cout);
+
+  SECTION("Pipeline") {
+    std::vector<int> received;
+    boson::run(1, [&]() {
+      local_channel<int, 4> a2b;
+      local_channel<int> b2c(1);
+
+      start(
+          [](auto out) -> void {
+            for (int index = 0; index < nb_iter; ++index) out << index;
+            out.close();
+          },
+          a2b);
+
+      start(
+          [](auto in, auto out) -> void {
+            int value = 0;
+            while (in >> value) out << value;
+            out.close();
+          },
+          a2b, b2c);
+
+      start(
+          [&received](auto in) -> void {
+            int value = 0;
+            while (in >> value) received.push_back(value);
+          },
+          b2c);
+    });
+    std::vector<int> expected(nb_iter, 0);
+    for (int index = 0; index < nb_iter; ++index) expected[index] = index;
+    CHECK(received == expected);
+  }
+
+  SECTION("Timeouts") {
+    boson::run(1, [&]() {
+      local_channel<int, 1> chan;
+      int value = 0;
+      CHECK(chan.read(value, time_factor()) == channel_result_value::timedout);
+      CHECK(chan.write(1));
+      CHECK(chan.write(2, time_factor()) == channel_result_value::timedout);
+
+      // A timed out reader must not steal a later element
+      local_channel<int, 1> other;
+      start(
+          [](auto chan) -> void {
+            int value = 0;
+            CHECK(chan.read(value, 1) == channel_result_value::timedout);
+          },
+          other);
+      boson::sleep(time_factor() * 5ms);
+      CHECK(other.write(3));
+      CHECK(other.read(value));
+      CHECK(value == 3);
+
+      // Timed out readers leave nothing behind for later posts
+      for (int index = 0; index < nb_iter; ++index)
+        CHECK(other.read(value, 0) == channel_result_value::timedout);
+      CHECK(other.write(4));
+      CHECK(other.read(value));
+      CHECK(value == 4);
+    });
+  }
+
+  SECTION("Moved from channels") {
+    boson::run(1, [&]() {
+      local_channel<int, 1> chan;
+      local_channel<int, 1> moved{std::move(chan)};
+      local_channel<int, 1> copy{chan};
+      copy = chan;
+      chan = moved;
+      CHECK(chan.write(1));
+      int value = 0;
+      CHECK(moved.read(value));
+      CHECK(value == 1);
+    });
+  }
+
+  SECTION("Closing wakes up readers") {
+    boson::run(1, [&]() {
+      local_channel<int, 1> chan;
+      start(
+          [](auto chan) -> void {
+            int value = 0;
+            CHECK(chan.read(value) == channel_result_value::closed);
+          },
+          chan);
+      boson::yield();
+      chan.close();
+      CHECK(chan.write(1) == channel_result_value::closed);
+    });
+  }
+}
@@ -0,0 +1,96 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <list>
+#include <map>
+#include <thread>
+#include <vector>
+#include "boson/memory/slab_allocator.h"
+#include "catch.hpp"
+
+using namespace boson::memory;
+
+TEST_CASE("Slab allocator - Local allocations", "[memory][slab_allocator]") {
+  SECTION("Alignment and reuse") {
+    for (std::size_t size : {0u, 1u, 16u, 17u, 100u, 512u, 1008u}) {
+      void* block = slab_allocate(size);
+      CHECK(0 == reinterpret_cast<std::uintptr_t>(block) % slab_alignment);
+      std::memset(block, 0xff, size);
+      slab_deallocate(block);
+      // Freed blocks are given back first
+      void* other = slab_allocate(size);
+      CHECK(block == other);
+      slab_deallocate(other);
+    }
+  }
+
+  SECTION("Large blocks") {
+    auto block = static_cast<char*>(slab_allocate(64 * 1024));
+    block[64 * 1024 - 1] = 'a';
+    CHECK(0 == reinterpret_cast<std::uintptr_t>(block) % slab_alignment);
+    slab_deallocate(block);
+    slab_deallocate(nullptr);
+  }
+
+  SECTION("Over aligned types") {
+    struct alignas(64) aligned_type {
+      char data[100];
+    };
+    slab_allocator<aligned_type> allocator;
+    std::vector<aligned_type*> blocks;
+    for (std::size_t n : {1u, 2u, 3u, 20u}) {
+      blocks.emplace_back(allocator.allocate(n));
+      CHECK(0 == reinterpret_cast<std::uintptr_t>(blocks.back()) % alignof(aligned_type));
+      std::memset(blocks.back(), 0xff, n * sizeof(aligned_type));
+    }
+    for (auto block : blocks) allocator.deallocate(block, 1);
+    CHECK_THROWS_AS(slab_allocator<std::uint64_t>{}.allocate(std::size_t(-1) / 4),
+                    std::bad_alloc);
+  }
+
+  SECTION("Standard containers") {
+    std::map<int, int, std::less<int>, slab_allocator<std::pair<int const, int>>> values;
+    for (int index = 0; index < 10000; ++index) values[index] = index;
+    std::list<int, slab_allocator<int>> numbers(values.size(), 1);
+    std::vector<int, slab_allocator<int>> large(100000, 2);
+    CHECK(10000 == values.size());
+    CHECK(9999 == values.rbegin()->second);
+    CHECK(10000 == numbers.size());
+    CHECK(2 == large.back());
+  }
+}
+
+TEST_CASE("Slab allocator - Remote frees", "[memory][slab_allocator]") {
+  constexpr std::size_t nb_blocks = 1e4;
+  constexpr std::size_t block_size = 1000;
+  std::vector<void*> blocks;
+  for (std::size_t index = 0; index < nb_blocks; ++index) {
+    auto block = static_cast<std::size_t*>(slab_allocate(block_size));
+    *block = index;
+    blocks.emplace_back(block);
+  }
+  std::sort(begin(blocks), end(blocks));
+
+  // Another thread frees them, they go back to this one
+  std::thread other{[&blocks]() {
+    for (void* block : blocks) slab_deallocate(block);
+  }};
+  other.join();
+
+  // Blocks freed earlier by this thread come first
+  std::size_t nb_reused = 0;
+  std::vector<void*> new_blocks;
+  while (nb_reused < nb_blocks && new_blocks.size() < 2 * nb_blocks) {
+    new_blocks.emplace_back(slab_allocate(block_size));
+    nb_reused += std::binary_search(begin(blocks), end(blocks), new_blocks.back());
+  }
+  CHECK(nb_blocks == nb_reused);
+  for (void* block : new_blocks) slab_deallocate(block);
+
+  // Blocks of a finished thread stay valid
+  void* orphan = nullptr;
+  std::thread allocator{[&orphan]() { orphan = slab_allocate(64); }};
+  allocator.join();
+  std::memset(orphan, 0, 64);
+  slab_deallocate(orphan);
+}
@@ -0,0 +1,136 @@
+#include "catch.hpp"
+#include "boson/boson.h"
+#include "boson/net/stream.h"
+#include "boson/select.h"
+#include <sys/socket.h>
+#include <unistd.h>
+#include <iostream>
+#include "boson/logger.h"
+
+using namespace boson;
+using namespace std::literals;
+
+TEST_CASE("Net - Stream", "[net][stream]") {
+  boson::debug::logger_instance(&std::cout);
+
+  SECTION("Line oriented exchange") {
+    boson::run(1, []() {
+      int sv[2];
+      REQUIRE(0 == ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, sv));
+      start(
+          [](int fd) -> void {
+            net::stream peer(fd, 16, 16);
+            // Waiting for the answer flushes the request
+            peer.write("ping\nping\n", 10);
+            std::string line;
+            CHECK(peer.read_until(line, '\n', 1000ms) == 5);
+            CHECK(line == "pong\n");
+            // A line longer than the buffer
+            std::string long_line(40, 'a');
+            long_line += '\n';
+            CHECK(peer.write(long_line.data(), long_line.size()) == long_line.size());
+            CHECK(peer.flush() == 0);
+            ::shutdown(fd, SHUT_WR);
+          },
+          sv[0]);
+
+      net::stream server(sv[1], 16, 16);
+      std::string line;
+      CHECK(server.read_until(line, '\n') == 5);
+      CHECK(line == "ping\n");
+      // Second line is already buffered
+      CHECK(0 < server.buffered());
+      line.clear();
+      CHECK(server.read_until(line, '\n') == 5);
+      server.write("pong\n", 5);
+      server.flush();
+
+      line.clear();
+      CHECK(server.read_until(line, '\n') == 41);
+      CHECK(line.size() == 41);
+      line.clear();
+      CHECK(server.read_until(line, '\n') == 0);
+      boson::close(sv[0]);
+      boson::close(sv[1]);
+    });
+  }
+
+  SECTION("Exact reads and peeking") {
+    boson::run(1, []() {
+      int sv[2];
+      REQUIRE(0 == ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, sv));
+      start(
+          [](int fd) -> void {
+            uint32_t header = 6;
+            boson::write(fd, &header, 2);
+            boson::usleep(1ms);
+            boson::write(fd, reinterpret_cast<char*>(&header) + 2, 2);
+            boson::write(fd, "abcdef", 6);
+          },
+          sv[0]);
+
+      net::stream input(sv[1]);
+      char const* data = nullptr;
+      ssize_t available = input.peek(data, 4, 1000ms);
+      REQUIRE(4 <= available);
+      uint32_t header = 0;
+      std::memcpy(&header, data, 4);
+      CHECK(header == 6);
+      input.consume(4);
+      std::array<char, 6> body;
+      CHECK(input.read_exact(body.data(), body.size()) == 6);
+      CHECK(std::string(body.data(), 6) == "abcdef");
+
+      // Nothing more comes
+      CHECK(input.read(body.data(), body.size(), 5ms) == -1);
+      CHECK(errno == ETIMEDOUT);
+      boson::close(sv[0]);
+      boson::close(sv[1]);
+    });
+  }
+
+  SECTION("Select") {
+    boson::run(1, []() {
+      int sv[2];
+      REQUIRE(0 == ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, sv));
+      net::stream input(sv[1]);
+      std::array<char, 2> buffer;
+      ssize_t rc = select_any(event_read(input, buffer.data(), buffer.size(),
+                                         [](ssize_t rc) { return rc; }),
+                              event_timer(5ms, []() { return ssize_t{-2}; }));
+      CHECK(rc == -2);
+
+      start([](int fd) -> void { boson::write(fd, "xyz", 3); }, sv[0]);
+      rc = select_any(event_read(input, buffer.data(), buffer.size(),
+                                 [](ssize_t rc) { return rc; }),
+                      event_timer(1000ms, []() { return ssize_t{-2}; }));
+      CHECK(rc == 2);
+      // The rest is served from the buffer, without waiting
+      rc = select_any(event_read(input, buffer.data(), buffer.size(),
+                                 [](ssize_t rc) { return rc; }));
+      CHECK(rc == 1);
+      CHECK(buffer[0] == 'z');
+      boson::close(sv[0]);
+      boson::close(sv[1]);
+    });
+  }
+
+  SECTION("Failed overflowing write") {
+    boson::run(1, []() {
+      int sv[2];
+      REQUIRE(0 == ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, sv));
+      net::stream output(sv[0], 16, 16);
+      CHECK(output.write("0123456789", 10) == 10);
+      // The buffered bytes get out, the socket fills up before the rest does
+      std::string overflow(1 << 24, 'a');
+      CHECK(output.write(overflow.data(), overflow.size(), 5ms) == -1);
+      // Nothing is left to send again
+      CHECK(output.flush(5ms) == 0);
+      std::array<char, 10> head;
+      CHECK(boson::read(sv[1], head.data(), head.size()) == 10);
+      CHECK(std::string(head.data(), head.size()) == "0123456789");
+      boson::close(sv[0]);
+      boson::close(sv[1]);
+    });
+  }
+}
@@ -0,0 +1,93 @@
+#include "catch.hpp"
+#include "boson/boson.h"
+#include "boson/channel.h"
+#include "boson/net/write_combiner.h"
+#include <sys/socket.h>
+#include <algorithm>
+#include <iostream>
+#include "boson/logger.h"
+
+using namespace boson;
+using namespace std::literals;
+
+TEST_CASE("Net - Write combiner", "[net][write_combiner]") {
+  boson::debug::logger_instance(&std::cout);
+  constexpr int const nb_writers = 50;
+
+  SECTION("Writers from several threads") {
+    boson::run(2, []() {
+      int sv[2];
+      REQUIRE(0 == ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, sv));
+      net::write_combiner combiner(sv[0]);
+      channel<ssize_t, nb_writers> results;
+      for (int index = 0; index < nb_writers; ++index) {
+        start(
+            [](net::write_combiner combiner, int value, auto results) -> void {
+              // Each writer sends its value twice, to check writes are not interleaved
+              std::array<int, 2> message{{value, value}};
+              results << combiner.write(message.data(), sizeof(message));
+            },
+            combiner, index, results);
+      }
+
+      std::array<std::array<int, 2>, nb_writers> received;
+      size_t nb_bytes = 0;
+      while (nb_bytes < sizeof(received)) {
+        ssize_t rc = boson::read(sv[1], reinterpret_cast<char*>(received.data()) + nb_bytes,
+                                 sizeof(received) - nb_bytes, 1000ms);
+        REQUIRE(0 < rc);
+        nb_bytes += rc;
+      }
+      for (int index = 0; index < nb_writers; ++index) {
+        ssize_t rc = 0;
+        results >> rc;
+        CHECK(rc == sizeof(int) * 2);
+      }
+
+      std::sort(begin(received), end(received));
+      for (int index = 0; index < nb_writers; ++index) {
+        CHECK(received[index][0] == index);
+        CHECK(received[index][1] == index);
+      }
+      boson::close(sv[0]);
+      boson::close(sv[1]);
+    });
+  }
+
+  SECTION("Repeated writes") {
+    constexpr int const nb_messages = 100;
+    boson::run(3, []() {
+      int sv[2];
+      REQUIRE(0 == ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, sv));
+      net::write_combiner combiner(sv[0]);
+      for (int index = 0; index < nb_writers; ++index) {
+        start(
+            [](net::write_combiner combiner, int value) -> void {
+              for (int message = 0; message < nb_messages; ++message) {
+                std::array<int, 2> data{{value, message}};
+                combiner.write(data.data(), sizeof(data));
+              }
+            },
+            combiner, index);
+      }
+
+      // Messages of each writer come in order
+      std::vector<std::array<int, 2>> received(nb_writers * nb_messages);
+      size_t nb_bytes = 0;
+      size_t const nb_expected = received.size() * sizeof(received[0]);
+      while (nb_bytes < nb_expected) {
+        ssize_t rc = boson::read(sv[1], reinterpret_cast<char*>(received.data()) + nb_bytes,
+                                 nb_expected - nb_bytes, 1000ms);
+        REQUIRE(0 < rc);
+        nb_bytes += rc;
+      }
+      std::vector<int> next_message(nb_writers, 0);
+      for (auto& message : received) {
+        CHECK(message[1] == next_message[message[0]]);
+        ++next_message[message[0]];
+      }
+      boson::close(sv[0]);
+      boson::close(sv[1]);
+    });
+  }
+}
@@ -0,0 +1,148 @@
+/**
+ * This executable counts the heap allocations made by the runtime
+ *
+ * Once warmed up, switching between routines, exchanging through channels
+ * and waiting for fds should not allocate anything : the objects of the
+ * runtime come from the slabs of the threads.
+ */
+#include <fcntl.h>
+#include <unistd.h>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include "boson/boson.h"
+#include "boson/channel.h"
+#include "boson/routine_handle.h"
+
+namespace {
+std::atomic<std::size_t> nb_allocations{0};
+}
+
+void* operator new(std::size_t size) {
+  nb_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* block = std::malloc(size ? size : 1)) return block;
+  throw std::bad_alloc{};
+}
+
+void operator delete(void* block) noexcept {
+  std::free(block);
+}
+
+void operator delete(void* block, std::size_t) noexcept {
+  std::free(block);
+}
+
+static constexpr size_t nb_warmup_iter = 1e4;
+static constexpr size_t nb_iter = 1e5;
+
+template <class Loop>
+std::size_t count_allocations(Loop& loop, std::size_t nb_loops) {
+  std::size_t before = nb_allocations.load(std::memory_order_relaxed);
+  loop(nb_loops);
+  return nb_allocations.load(std::memory_order_relaxed) - before;
+}
+
+/**
+ * Counts allocations of a loop once warmed up
+ *
+ * Loops start routines and create channels first, so they are run twice with
+ * different lengths : the difference is what the iterations allocate.
+ */
+template <class Loop>
+bool measure(char const* name, Loop loop) {
+  loop(nb_warmup_iter);
+  std::size_t nb_setup = count_allocations(loop, nb_iter);
+  std::size_t nb_steady = count_allocations(loop, 2 * nb_iter) - nb_setup;
+  std::printf("%-24s %zu allocations for the setup, %zu for %zu iterations\n", name, nb_setup,
+              nb_steady, nb_iter);
+  return 0 == nb_steady;
+}
+
+/**
+ * Counts what a loop allocates beyond a reference loop doing less
+ */
+template <class Loop, class Reference>
+bool measure_beyond(char const* name, char const* reference_name, Loop loop,
+                    Reference reference) {
+  loop(nb_warmup_iter);
+  reference(nb_warmup_iter);
+  std::size_t nb_loop = count_allocations(loop, nb_iter);
+  std::size_t nb_reference = count_allocations(reference, nb_iter);
+  std::size_t nb_beyond = nb_reference < nb_loop ? nb_loop - nb_reference : 0;
+  std::printf("%-24s %zu allocations beyond %s for %zu iterations\n", name, nb_beyond,
+              reference_name, nb_iter);
+  return 0 == nb_beyond;
+}
+
+int main(void) {
+  using namespace boson;
+  bool success = true;
+
+  int pipe_in[2], pipe_out[2];
+  if (::pipe(pipe_in) < 0 || ::pipe(pipe_out) < 0) return 1;
+  for (int fd : {pipe_in[0], pipe_in[1], pipe_out[0], pipe_out[1]})
+    ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+  boson::run(2, [&]() {
+    success &= measure("context switch", [](size_t nb_loops) {
+      bool stop = false;
+      start_explicit(0, [](bool* stop) -> void {
+        while (!*stop) boson::yield();
+      }, &stop);
+      for (size_t index = 0; index < nb_loops; ++index) boson::yield();
+      stop = true;
+      boson::yield();
+    });
+
+    for (thread_id peer_thread : {0, 1}) {
+      success &= measure(peer_thread ? "channel across threads" : "channel", [&](size_t nb_loops) {
+        channel<int, 1> ping;
+        channel<int, 1> pong;
+        start_explicit(peer_thread, [](auto ping, auto pong, size_t nb_loops) -> void {
+          int value = 0;
+          for (size_t index = 0; index < nb_loops; ++index) {
+            ping >> value;
+            pong << value;
+          }
+        }, ping, pong, nb_loops);
+        int value = 0;
+        for (size_t index = 0; index < nb_loops; ++index) {
+          ping << value;
+          pong >> value;
+        }
+      });
+    }
+
+    // Starting a routine allocates its engine command, joining it must add nothing
+    success &= measure_beyond("joined routine", "starting routines", [](size_t nb_loops) {
+      for (size_t index = 0; index < nb_loops; ++index)
+        start_joinable([](size_t value) { return value; }, index).get();
+    }, [](size_t nb_loops) {
+      for (size_t index = 0; index < nb_loops; ++index) {
+        bool done = false;
+        start([](bool* done) -> void { *done = true; }, &done);
+        while (!done) boson::yield();
+      }
+    });
+
+    for (thread_id peer_thread : {0, 1}) {
+      success &= measure(peer_thread ? "fd wait across threads" : "fd wait", [&](size_t nb_loops) {
+        start_explicit(peer_thread, [](int in, int out, size_t nb_loops) -> void {
+          char value = 0;
+          for (size_t index = 0; index < nb_loops; ++index) {
+            boson::read(in, &value, 1);
+            boson::write(out, &value, 1);
+          }
+        }, pipe_in[0], pipe_out[1], nb_loops);
+        char value = 0;
+        for (size_t index = 0; index < nb_loops; ++index) {
+          boson::write(pipe_in[1], &value, 1);
+          boson::read(pipe_out[0], &value, 1);
+        }
+      });
+    }
+  });
+
+  return success ? 0 : 1;
+}
@@ -0,0 +1,71 @@
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "boson/queues/segmented_queue.h"
+#include "catch.hpp"
+
+TEST_CASE("Segmented queue - Simple behavior", "[queues][segmented_queue]") {
+  boson::queues::segmented_queue<int, 4> queue;
+  int value = 0;
+  CHECK(queue.empty());
+  CHECK(!queue.read(value));
+
+  // Over several segments, values come out in order
+  for (int index = 0; index < 100; ++index) queue.write(index);
+  CHECK(!queue.empty());
+  for (int index = 0; index < 100; ++index) {
+    CHECK(queue.read(value));
+    CHECK(value == index);
+  }
+  CHECK(queue.empty());
+  CHECK(!queue.read(value));
+}
+
+TEST_CASE("Segmented queue - Values left are destroyed", "[queues][segmented_queue]") {
+  auto counter = std::make_shared<int>(0);
+  {
+    boson::queues::segmented_queue<std::shared_ptr<int>, 4> queue;
+    for (int index = 0; index < 10; ++index) queue.write(counter);
+    std::shared_ptr<int> value;
+    for (int index = 0; index < 5; ++index) CHECK(queue.read(value));
+    value.reset();
+    CHECK(counter.use_count() == 6);
+  }
+  CHECK(counter.use_count() == 1);
+}
+
+TEST_CASE("Segmented queue - Concurrent accesses", "[queues][segmented_queue]") {
+  constexpr std::size_t nb_producers = 4;
+  constexpr std::size_t nb_consumers = 4;
+  constexpr std::size_t nb_iter = 1e5;
+  boson::queues::segmented_queue<std::size_t, 8> queue;
+  std::atomic<std::size_t> nb_read{0};
+  std::atomic<std::size_t> sum_read{0};
+
+  std::vector<std::thread> threads;
+  for (std::size_t producer = 0; producer < nb_producers; ++producer) {
+    threads.emplace_back([&, producer]() {
+      for (std::size_t index = 0; index < nb_iter; ++index)
+        queue.write(producer * nb_iter + index);
+    });
+  }
+  for (std::size_t consumer = 0; consumer < nb_consumers; ++consumer) {
+    threads.emplace_back([&]() {
+      std::size_t value = 0;
+      while (nb_read.load() < nb_producers * nb_iter) {
+        if (queue.read(value)) {
+          ++nb_read;
+          sum_read += value;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  // Every value has been read once
+  std::size_t total = nb_producers * nb_iter;
+  CHECK(nb_read == total);
+  CHECK(sum_read == total * (total - 1) / 2);
+  CHECK(queue.empty());
+}
@@ -0,0 +1,114 @@
+#include <array>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "boson/queues/waiter_queue.h"
+#include "catch.hpp"
+
+namespace {
+struct target {};
+}
+
+TEST_CASE("Waiter queue - Simple behavior", "[queues][waiter_queue]") {
+  boson::queues::waiter_queue<target> queue;
+  target first, second, third;
+  boson::queues::waiter_queue<target>::value_type waiter;
+  CHECK(!queue.read(waiter));
+
+  auto first_handle = queue.write(&first, 1);
+  auto second_handle = queue.write(&second, 2);
+  queue.write(&third, 3);
+
+  // Cancelled waiters are skipped
+  CHECK(queue.cancel(second_handle));
+  CHECK(!queue.cancel(second_handle));
+  CHECK(queue.read(waiter));
+  CHECK(waiter.first == &first);
+  CHECK(waiter.second == 1);
+  CHECK(queue.read(waiter));
+  CHECK(waiter.first == &third);
+  CHECK(waiter.second == 3);
+  CHECK(!queue.read(waiter));
+
+  // Read waiters cannot be cancelled, even once their node is recycled
+  CHECK(!queue.cancel(first_handle));
+  for (std::size_t index = 0; index < 100; ++index) queue.write(&first, index);
+  CHECK(!queue.cancel(first_handle));
+  for (std::size_t index = 0; index < 100; ++index) {
+    CHECK(queue.read(waiter));
+    CHECK(waiter.second == index);
+  }
+  CHECK(!queue.read(waiter));
+}
+
+TEST_CASE("Waiter queue - Cancelled nodes are recycled", "[queues][waiter_queue]") {
+  boson::queues::waiter_queue<target> queue;
+  target first, second;
+  boson::queues::waiter_queue<target>::value_type waiter;
+
+  // Timed out waits, nobody reads the queue
+  std::size_t nb_cancelled = 0;
+  for (std::size_t index = 0; index < 1e5; ++index)
+    nb_cancelled += queue.cancel(queue.write(&first, index));
+  CHECK(nb_cancelled == 1e5);
+  CHECK(queue.nb_nodes() < 8);
+
+  // Behind a live waiter, tombstones go away once it is read
+  queue.write(&second, 0);
+  for (std::size_t index = 0; index < 1e3; ++index) queue.cancel(queue.write(&first, index));
+  CHECK(queue.read(waiter));
+  CHECK(waiter.first == &second);
+  for (std::size_t index = 0; index < 1e5; ++index) queue.cancel(queue.write(&first, index));
+  CHECK(queue.nb_nodes() < 1100);
+  CHECK(!queue.read(waiter));
+}
+
+TEST_CASE("Waiter queue - Concurrent accesses", "[queues][waiter_queue]") {
+  constexpr std::size_t nb_producers = 4;
+  constexpr std::size_t nb_consumers = 4;
+  constexpr std::size_t nb_iter = 1e4;
+  boson::queues::waiter_queue<target> queue;
+  target dummy;
+  std::atomic<std::size_t> nb_cancelled{0};
+  std::atomic<std::size_t> nb_read{0};
+  std::atomic<std::size_t> sum_read{0};
+  std::atomic<std::size_t> sum_cancelled{0};
+  std::atomic<bool> done{false};
+
+  std::vector<std::thread> threads;
+  for (std::size_t producer = 0; producer < nb_producers; ++producer) {
+    threads.emplace_back([&, producer]() {
+      for (std::size_t index = 0; index < nb_iter; ++index) {
+        std::size_t value = producer * nb_iter + index;
+        auto handle = queue.write(&dummy, value);
+        // Cancel one out of three, as timeouts would
+        if (0 == index % 3 && queue.cancel(handle)) {
+          ++nb_cancelled;
+          sum_cancelled += value;
+        }
+      }
+    });
+  }
+  for (std::size_t consumer = 0; consumer < nb_consumers; ++consumer) {
+    threads.emplace_back([&]() {
+      boson::queues::waiter_queue<target>::value_type waiter;
+      for (;;) {
+        bool finished = done.load();
+        if (queue.read(waiter)) {
+          ++nb_read;
+          sum_read += waiter.second;
+        } else if (finished) {
+          break;
+        }
+      }
+    });
+  }
+  for (std::size_t producer = 0; producer < nb_producers; ++producer) threads[producer].join();
+  done = true;
+  for (std::size_t index = nb_producers; index < threads.size(); ++index) threads[index].join();
+
+  // Every waiter has been either read or cancelled, once
+  std::size_t total = nb_producers * nb_iter;
+  CHECK(nb_read + nb_cancelled == total);
+  CHECK(sum_read + sum_cancelled == total * (total - 1) / 2);
+}
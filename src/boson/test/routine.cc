@@ -5,6 +5,7 @@
 #include "boson/logger.h"
 #include "boson/semaphore.h"
 #include "boson/select.h"
+#include "boson/exception.h"
 
 using namespace boson;
 using namespace std::literals;
@@ -42,3 +43,33 @@ TEST_CASE("Routines - Panic", "[routines][panic]") {
   });
 
 }
+
+TEST_CASE("Routines - Migration", "[routines][migration]") {
+  std::vector<std::size_t> visited;
+  int nb_received = 0;
+  boson::run(3, [&]() {
+    using namespace boson;
+    channel<int, 1> chan;
+    start_explicit(0, [&](auto chan) -> void {
+      visited.push_back(internal::current_thread()->id());
+      for (std::size_t target : {1u, 2u, 0u, 2u}) {
+        migrate_to(target);
+        visited.push_back(internal::current_thread()->id());
+        // Events are registered in the new thread
+        boson::sleep(time_factor() * 1ms);
+        int value = 0;
+        chan >> value;
+        ++nb_received;
+      }
+      CHECK_THROWS_AS(migrate_to(3), boson::exception);
+    }, chan);
+    for (int index = 0; index < 4; ++index) chan << index;
+  });
+  REQUIRE(visited.size() == 5);
+  CHECK(visited[0] == 0);
+  CHECK(visited[1] == 1);
+  CHECK(visited[2] == 2);
+  CHECK(visited[3] == 0);
+  CHECK(visited[4] == 2);
+  CHECK(nb_received == 4);
+}
@@ -0,0 +1,55 @@
+#include "catch.hpp"
+#include "boson/boson.h"
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "boson/routine_arena.h"
+
+using namespace boson;
+using namespace std::literals;
+
+namespace {
+using arena_string = std::basic_string<char, std::char_traits<char>, arena_allocator<char>>;
+}
+
+TEST_CASE("Routine arena", "[routine_arena]") {
+  SECTION("Allocations") {
+    routine_arena arena;
+    for (std::size_t alignment : {1u, 8u, 16u, 64u}) {
+      void* pointer = arena.allocate(3, alignment);
+      CHECK(0 == reinterpret_cast<std::uintptr_t>(pointer) % alignment);
+    }
+    // Larger than a chunk
+    auto large = static_cast<char*>(arena.allocate(4 * routine_arena::chunk_size));
+    large[4 * routine_arena::chunk_size - 1] = 'a';
+    // Many chunks
+    for (int index = 0; index < 1000; ++index) {
+      auto small = static_cast<std::uint64_t*>(arena.allocate(512, alignof(std::uint64_t)));
+      small[63] = index;
+    }
+    CHECK(4 * routine_arena::chunk_size + 512000 + 12 == arena.nb_bytes_allocated());
+    arena.release();
+    CHECK(0 == arena.nb_bytes_allocated());
+  }
+
+  SECTION("Arenas of routines") {
+    std::atomic<int> nb_errors{0};
+    boson::run(2, [&]() {
+      for (int index = 0; index < 100; ++index) {
+        start([&](int index) {
+          std::vector<arena_string, arena_allocator<arena_string>> words;
+          for (int word = 0; word < 100; ++word)
+            words.emplace_back((std::to_string(index * word) + " is a rather long word").c_str());
+          boson::yield();
+          for (int word = 0; word < 100; ++word) {
+            if (words[word] != (std::to_string(index * word) + " is a rather long word").c_str())
+              ++nb_errors;
+          }
+          if (0 == routine_arena::current().nb_bytes_allocated()) ++nb_errors;
+        }, index);
+      }
+    });
+    CHECK(nb_errors == 0);
+  }
+}
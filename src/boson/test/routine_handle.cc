@@ -0,0 +1,86 @@
+#include "catch.hpp"
+#include "boson/boson.h"
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "boson/routine_handle.h"
+#include "boson/select.h"
+
+using namespace boson;
+using namespace std::literals;
+
+namespace {
+inline int time_factor() {
+#ifdef BOSON_USE_VALGRIND
+  return RUNNING_ON_VALGRIND ? 10 : 1;
+#else
+  return 1;
+#endif
+}
+}
+
+TEST_CASE("Routine handle", "[routine_handle]") {
+  SECTION("Results") {
+    boson::run(2, [&]() {
+      auto doubled = start_joinable([](int value) { return 2 * value; }, 21);
+      auto text = start_joinable([]() {
+        boson::sleep(time_factor() * 5ms);
+        return std::string("done");
+      });
+      bool executed = false;
+      auto nothing = start_joinable([&executed]() { executed = true; });
+      CHECK(doubled.get() == 42);
+      CHECK(text.get() == "done");
+      CHECK(text.finished());
+      nothing.get();
+      CHECK(executed);
+    });
+  }
+
+  SECTION("Exceptions") {
+    boson::run(1, [&]() {
+      auto failing = start_joinable([]() -> int { throw std::runtime_error("failed"); });
+      CHECK(failing.join());
+      CHECK_THROWS_AS(failing.get(), std::runtime_error);
+    });
+  }
+
+  SECTION("Fan out") {
+    constexpr int nb_routines = 1000;
+    long long sum = 0;
+    boson::run(4, [&]() {
+      std::vector<routine_handle<long long>> handles;
+      for (int index = 0; index < nb_routines; ++index)
+        handles.push_back(start_joinable([](long long value) { return value * value; }, index));
+      for (auto& handle : handles) sum += handle.get();
+    });
+    CHECK(sum == 332833500);
+  }
+
+  SECTION("Timeout") {
+    boson::run(1, [&]() {
+      auto slow = start_joinable([]() {
+        boson::sleep(time_factor() * 20ms);
+        return 1;
+      });
+      CHECK(slow.join(time_factor() * 5ms) == semaphore_return_value::timedout);
+      CHECK(slow.get() == 1);
+    });
+  }
+
+  SECTION("Select") {
+    boson::run(1, [&]() {
+      auto slow = start_joinable([]() {
+        boson::sleep(time_factor() * 10ms);
+        return 1;
+      });
+      int result = select_any(event_join(slow, []() { return 1; }),
+                              event_timer(time_factor() * 5ms, []() { return 2; }));
+      CHECK(result == 2);
+      result = select_any(event_join(slow, []() { return 1; }),
+                          event_timer(time_factor() * 100ms, []() { return 2; }));
+      CHECK(result == 1);
+      CHECK(slow.get() == 1);
+    });
+  }
+}
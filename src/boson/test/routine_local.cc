@@ -0,0 +1,106 @@
+#include "catch.hpp"
+#include "boson/boson.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include "boson/exception.h"
+#include "boson/routine_local.h"
+
+using namespace boson;
+using namespace std::literals;
+
+namespace {
+inline int time_factor() {
+#ifdef BOSON_USE_VALGRIND
+  return RUNNING_ON_VALGRIND ? 10 : 1;
+#else
+  return 1;
+#endif
+}
+
+struct tracked {
+  static std::atomic<int> nb_alive;
+  int value = 0;
+  tracked() {
+    nb_alive.fetch_add(1);
+  }
+  ~tracked() {
+    nb_alive.fetch_sub(1);
+  }
+};
+std::atomic<int> tracked::nb_alive{0};
+}
+
+TEST_CASE("Routine local", "[routine_local]") {
+  SECTION("One value per routine") {
+    routine_local<int> counter;
+    routine_local<std::string> name("none");
+    std::atomic<int> nb_errors{0};
+    boson::run(2, [&]() {
+      for (int index = 0; index < 10; ++index) {
+        start([&](int index) {
+          if (counter.has_value() || *name != "none") ++nb_errors;
+          for (int step = 0; step < index; ++step) {
+            ++counter.get();
+            boson::sleep(time_factor() * 1ms);
+          }
+          if (counter.get() != index) ++nb_errors;
+          name.get() = std::to_string(index);
+          boson::yield();
+          if (*name != std::to_string(index)) ++nb_errors;
+        }, index);
+      }
+    });
+    CHECK(nb_errors == 0);
+  }
+
+  SECTION("Values are destroyed with their routine") {
+    routine_local<tracked> local;
+    boson::run(2, [&]() {
+      for (int index = 0; index < 10; ++index) {
+        start([&]() {
+          local->value = 1;
+          boson::sleep(time_factor() * 1ms);
+        });
+      }
+      start([&]() {
+        local->value = 1;
+        local.reset();
+        CHECK(!local.has_value());
+      });
+    });
+    CHECK(tracked::nb_alive == 0);
+  }
+
+  SECTION("Values follow migrations") {
+    routine_local<int> local;
+    int value = 0;
+    boson::run(2, [&]() {
+      *local = 42;
+      migrate_to(1 - internal::current_thread()->id());
+      value = *local;
+    });
+    CHECK(value == 42);
+  }
+
+  SECTION("Keys of destroyed objects are given again") {
+    bool fresh = true;
+    boson::run(1, [&]() {
+      for (int index = 0; index < 1000; ++index) {
+        auto previous = std::make_unique<routine_local<tracked>>();
+        (*previous)->value = index;
+        previous.reset();
+        // The value left by the previous owner of the key is not seen
+        routine_local<int> local;
+        fresh &= !local.has_value() && 0 == *local;
+        fresh &= tracked::nb_alive == 0;
+      }
+    });
+    CHECK(fresh);
+  }
+
+  SECTION("Outside of routines") {
+    routine_local<int> local;
+    CHECK_THROWS_AS(local.get(), boson::exception);
+  }
+}
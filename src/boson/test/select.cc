@@ -423,4 +423,67 @@ TEST_CASE("Routines - Select", "[routines][i/o][select]") {
       boson::close(listening_socket);
     });
   }
+
+  SECTION("Default branch") {
+    boson::run(1, [&]() {
+      channel<int, 1> chan;
+      boson::mutex mut;
+      mut.lock();
+      int value = 0;
+      auto select_call = [&]() {
+        return select_any(                                          //
+            event_default([]() { return 0; }),                      //
+            event_read(chan, value, [](bool) { return 1; }),        //
+            event_lock(mut, []() { return 2; }),                    //
+            event_timer(1000ms * time_factor(), []() { return 3; })  //
+            );
+      };
+      CHECK(select_call() == 0);
+      chan << 5;
+      CHECK(select_call() == 1);
+      CHECK(value == 5);
+      CHECK(select_call() == 0);
+      mut.unlock();
+      CHECK(select_call() == 2);
+      CHECK(select_call() == 0);
+    });
+  }
+
+  SECTION("Select all") {
+    boson::run(2, [&]() {
+      channel<int, 1> first, second;
+      boson::mutex mut;
+      mut.lock();
+      int first_value = 0, second_value = 0;
+      start_explicit(1,
+                     [](auto first, auto second, auto mut) -> void {
+                       second << 2;
+                       boson::sleep(time_factor() * 5ms);
+                       first << 1;
+                       mut.unlock();
+                     },
+                     first, second, mut);
+      std::vector<int> order;
+      auto happened = select_all(                                                  //
+          event_read(first, first_value, [&](bool) { order.push_back(1); }),       //
+          event_read(second, second_value, [&](bool) { order.push_back(2); }),     //
+          event_lock(mut, [&]() { order.push_back(3); return 3; }));               //
+      CHECK(happened[0]);
+      CHECK(happened[1]);
+      CHECK(happened[2]);
+      CHECK(first_value == 1);
+      CHECK(second_value == 2);
+      CHECK(order.size() == 3);
+      CHECK(order.front() == 2);
+
+      // Nobody writes the second time
+      happened = select_all_for(time_factor() * 5ms,                                 //
+                                event_read(first, first_value, [&](bool) {}),        //
+                                event_read(second, second_value, [&](bool) {}),      //
+                                event_timer(0, []() {}));                           //
+      CHECK_FALSE(happened[0]);
+      CHECK_FALSE(happened[1]);
+      CHECK(happened[2]);
+    });
+  }
 }
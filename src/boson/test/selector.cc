@@ -0,0 +1,129 @@
+#include "catch.hpp"
+#include "boson/boson.h"
+#include "boson/selector.h"
+#include "boson/wait_group.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <iostream>
+#include "boson/logger.h"
+
+using namespace boson;
+using namespace std::literals;
+
+namespace {
+inline int time_factor() {
+#ifdef BOSON_USE_VALGRIND
+  return RUNNING_ON_VALGRIND ? 10 : 1;
+#else
+  return 1;
+#endif
+}
+}
+
+TEST_CASE("Selector", "[select][selector]") {
+  boson::debug::logger_instance(&std::cout);
+
+  SECTION("Channels known at run time") {
+    constexpr int nb_channels = 5;
+    constexpr int nb_iter = 100;
+    std::vector<int> sums(nb_channels, 0);
+    boson::run(2, [&]() {
+      std::vector<channel<int, 1>> channels(nb_channels);
+      for (auto& chan : channels) {
+        start_explicit(1,
+                       [](auto out) -> void {
+                         for (int index = 0; index < nb_iter; ++index) out << index;
+                         out.close();
+                       },
+                       chan);
+      }
+      std::vector<int> values(nb_channels, 0);
+      std::vector<bool> open(nb_channels, true);
+      std::vector<int> ids;  // Channel of every event
+      selector sel;
+      for (int id = 0; id < nb_channels; ++id) {
+        ids.push_back(id);
+        sel.add(event_read(channels[id], values[id],
+                           [&open, id](bool success) { open[id] = success; }));
+      }
+      while (0 < sel.size()) {
+        int index = sel.select();
+        REQUIRE(0 <= index);
+        int id = ids[index];
+        if (open[id]) {
+          sums[id] += values[id];
+        } else {
+          // A closed channel would always be picked
+          sel.erase(index);
+          ids.erase(ids.begin() + index);
+        }
+      }
+      CHECK(sel.select(time_factor() * 1ms) == -1);
+    });
+    for (int sum : sums) CHECK(sum == nb_iter * (nb_iter - 1) / 2);
+  }
+
+  SECTION("Fairness") {
+    boson::run(1, [&]() {
+      channel<int, 1> first, second;
+      int first_value = 0, second_value = 0;
+      first << 0;
+      second << 0;
+      std::vector<int> picked(2, 0);
+      selector sel;
+      sel.add(event_read(first, first_value, [&](bool) { first << 0; }));
+      sel.add(event_read(second, second_value, [&](bool) { second << 0; }));
+      for (int index = 0; index < 100; ++index) ++picked[sel.select()];
+      CHECK(picked[0] == 50);
+      CHECK(picked[1] == 50);
+    });
+  }
+
+  SECTION("File descriptors, mutexes and timeouts") {
+    int pipe_fds[2];
+    REQUIRE(0 == ::pipe(pipe_fds));
+    ::fcntl(pipe_fds[0], F_SETFL, ::fcntl(pipe_fds[0], F_GETFD) | O_NONBLOCK);
+    ::fcntl(pipe_fds[1], F_SETFL, ::fcntl(pipe_fds[1], F_GETFD) | O_NONBLOCK);
+    boson::run(1, [&]() {
+      boson::mutex mut;
+      mut.lock();
+      int data = 0;
+      ssize_t nread = 0;
+      selector sel;
+      CHECK(0 == sel.add(event_read(pipe_fds[0], &data, sizeof(data),
+                                    [&](ssize_t rc) { nread = rc; })));
+      CHECK(1 == sel.add(event_lock(mut, []() {})));
+      CHECK(sel.size() == 2);
+      CHECK(sel.select(time_factor() * 5ms) == -1);
+      start([](int out) -> void {
+        int value = 42;
+        boson::write(out, &value, sizeof(value));
+      }, pipe_fds[1]);
+      CHECK(sel.select() == 0);
+      CHECK(nread == sizeof(data));
+      CHECK(data == 42);
+      start([](auto mut) -> void { mut.unlock(); }, mut);
+      CHECK(sel.select() == 1);
+      sel.clear();
+      CHECK_THROWS_AS(sel.select(), boson::exception);
+    });
+    ::close(pipe_fds[0]);
+    ::close(pipe_fds[1]);
+  }
+
+  SECTION("Reused wait groups") {
+    boson::run(1, [&]() {
+      wait_group group;
+      selector sel;
+      sel.add(event_wait(group, []() {}));
+      group.add();
+      start([](auto group) -> void { group.done(); }, group);
+      CHECK(sel.select() == 0);
+      // The group is waited for again, the event must not fire right away
+      group.add();
+      CHECK(sel.select(time_factor() * 5ms) == -1);
+      start([](auto group) -> void { group.done(); }, group);
+      CHECK(sel.select() == 0);
+    });
+  }
+}
@@ -87,3 +87,117 @@ TEST_CASE("Semaphore - Disabling", "[semaphore]") {
     });
   }
 }
+
+TEST_CASE("Semaphore - Batches", "[semaphore]") {
+  boson::debug::logger_instance(&std::cout);
+
+  SECTION("Post wakes up several waiters") {
+    std::atomic<int> nb_woken{0};
+    boson::run(2, [&]() {
+      shared_semaphore sema(0);
+      shared_semaphore done(0);
+      for (int index = 0; index < 10; ++index) {
+        start(
+            [&nb_woken](auto sema, auto done) -> void {
+              CHECK(sema.wait());
+              ++nb_woken;
+              done.post();
+            },
+            sema, done);
+      }
+      boson::sleep(time_factor() * 5ms);
+      CHECK(nb_woken == 0);
+      sema.post(10);
+      CHECK(done.wait_n(10));
+      CHECK(sema.try_wait() == 0);
+    });
+    CHECK(nb_woken == 10);
+  }
+
+  SECTION("Wait for several tickets") {
+    boson::run(1, [&]() {
+      shared_semaphore sema(3);
+      CHECK(sema.wait_n(2));
+      CHECK(sema.wait_n(2, time_factor() * 5ms) == semaphore_return_value::timedout);
+      // The ticket left is not kept by the timed out wait
+      CHECK(sema.try_wait(5) == 1);
+
+      start([](auto sema) -> void {
+        boson::sleep(time_factor() * 5ms);
+        sema.post(2);
+      }, sema);
+      CHECK(sema.wait_n(2));
+    });
+  }
+
+  SECTION("Concurrent waits for several tickets") {
+    std::atomic<int> nb_done{0};
+    boson::run(2, [&]() {
+      shared_semaphore sema(0);
+      shared_semaphore done(0);
+      for (int index = 0; index < 2; ++index) {
+        start([&nb_done](auto sema, auto done) -> void {
+          sema.wait_n(2);
+          ++nb_done;
+          done.post();
+        }, sema, done);
+      }
+      boson::sleep(time_factor() * 5ms);
+      // Enough for one of them, the other must not hold any ticket meanwhile
+      sema.post();
+      sema.post();
+      CHECK(done.wait(time_factor() * 100ms));
+      boson::sleep(time_factor() * 5ms);
+      CHECK(nb_done == 1);
+      sema.post(2);
+      CHECK(done.wait(time_factor() * 100ms));
+      CHECK(nb_done == 2);
+    });
+  }
+}
+
+TEST_CASE("Semaphore - Same thread wake ups", "[semaphore]") {
+  boson::debug::logger_instance(&std::cout);
+  constexpr int nb_iter = 10000;
+
+  SECTION("Mutex ping-pong") {
+    std::vector<int> sequence;
+    boson::run(1, [&]() {
+      shared_semaphore ping(0), pong(0);
+      start([&sequence](auto ping, auto pong) -> void {
+        for (int index = 0; index < nb_iter; ++index) {
+          CHECK(ping.wait());
+          sequence.push_back(2 * index + 1);
+          pong.post();
+        }
+      }, ping, pong);
+      for (int index = 0; index < nb_iter; ++index) {
+        sequence.push_back(2 * index);
+        ping.post();
+        CHECK(pong.wait());
+      }
+    });
+    REQUIRE(sequence.size() == 2 * nb_iter);
+    bool in_order = true;
+    for (int index = 0; index < 2 * nb_iter; ++index) in_order &= sequence[index] == index;
+    CHECK(in_order);
+  }
+
+  SECTION("Timed out waiters pass the ticket on") {
+    boson::run(1, [&]() {
+      shared_semaphore sema(0);
+      int nb_woken = 0;
+      start([&nb_woken](auto sema) -> void {
+        if (sema.wait(1)) ++nb_woken;
+      }, sema);
+      start([&nb_woken](auto sema) -> void {
+        if (sema.wait()) ++nb_woken;
+      }, sema);
+      boson::sleep(time_factor() * 5ms);
+      sema.post();
+      boson::sleep(time_factor() * 5ms);
+      CHECK(nb_woken == 1);
+      sema.disable();
+    });
+  }
+}
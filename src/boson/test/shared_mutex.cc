@@ -0,0 +1,162 @@
+#include "catch.hpp"
+#include "boson/boson.h"
+#include <atomic>
+#include <vector>
+#include "boson/select.h"
+#include "boson/shared_mutex.h"
+
+using namespace boson;
+using namespace std::literals;
+
+namespace {
+inline int time_factor() {
+#ifdef BOSON_USE_VALGRIND
+  return RUNNING_ON_VALGRIND ? 10 : 1;
+#else
+  return 1;
+#endif
+}
+}
+
+TEST_CASE("Shared mutex", "[shared_mutex]") {
+  SECTION("Readers share the lock") {
+    int nb_readers = 0;
+    int max_readers = 0;
+    boson::run(1, [&]() {
+      shared_mutex mut;
+      for (int index = 0; index < 4; ++index) {
+        start([&](auto mut) -> void {
+          CHECK(mut.lock_shared());
+          max_readers = std::max(max_readers, ++nb_readers);
+          boson::sleep(time_factor() * 5ms);
+          --nb_readers;
+          mut.unlock_shared();
+        }, mut);
+      }
+    });
+    CHECK(max_readers == 4);
+  }
+
+  SECTION("Writers exclude everyone") {
+    boson::run(1, [&]() {
+      shared_mutex mut;
+      CHECK(mut.lock());
+      start([](auto mut) -> void {
+        CHECK(mut.lock_shared(time_factor() * 5ms) == semaphore_return_value::timedout);
+        CHECK(mut.lock(time_factor() * 5ms) == semaphore_return_value::timedout);
+        CHECK(mut.lock_shared());
+        mut.unlock_shared();
+        CHECK(mut.lock());
+        mut.unlock();
+      }, mut);
+      boson::sleep(time_factor() * 20ms);
+      mut.unlock();
+    });
+  }
+
+  SECTION("Writers go before late readers") {
+    std::vector<int> order;
+    boson::run(1, [&]() {
+      shared_mutex mut;
+      CHECK(mut.lock_shared());
+      start([&](auto mut) -> void {
+        CHECK(mut.lock());
+        order.push_back(1);
+        boson::sleep(time_factor() * 5ms);
+        mut.unlock();
+      }, mut);
+      start([&](auto mut) -> void {
+        boson::sleep(time_factor() * 5ms);
+        CHECK(mut.lock_shared());
+        order.push_back(2);
+        mut.unlock_shared();
+      }, mut);
+      boson::sleep(time_factor() * 10ms);
+      mut.unlock_shared();
+    });
+    REQUIRE(order.size() == 2);
+    CHECK(order[0] == 1);
+    CHECK(order[1] == 2);
+  }
+
+  SECTION("Multiple threads") {
+    constexpr int nb_iterations = 2000;
+    std::atomic<int> nb_readers{0};
+    std::atomic<int> nb_writers{0};
+    std::atomic<int> nb_violations{0};
+    int value = 0;
+    boson::run(4, [&]() {
+      shared_mutex mut;
+      for (int index = 0; index < 8; ++index) {
+        start([&](auto mut, bool writer) -> void {
+          for (int iteration = 0; iteration < nb_iterations; ++iteration) {
+            if (writer) {
+              mut.lock();
+              if (0 < nb_readers.load() || 0 < nb_writers.fetch_add(1)) ++nb_violations;
+              ++value;
+              nb_writers.fetch_sub(1);
+              mut.unlock();
+            } else {
+              mut.lock_shared();
+              nb_readers.fetch_add(1);
+              if (0 < nb_writers.load()) ++nb_violations;
+              nb_readers.fetch_sub(1);
+              mut.unlock_shared();
+            }
+            if (0 == iteration % 64) boson::yield();
+          }
+        }, mut, 0 == index % 4);
+      }
+    });
+    CHECK(nb_violations == 0);
+    CHECK(value == 2 * nb_iterations);
+  }
+
+  SECTION("Select") {
+    boson::run(1, [&]() {
+      shared_mutex mut;
+      CHECK(mut.lock());
+      start([](auto mut) -> void {
+        int result = select_any(
+            event_lock_shared(mut, []() { return 1; }),
+            event_timer(time_factor() * 5ms, []() { return 2; }));
+        CHECK(result == 2);
+        result = select_any(
+            event_lock_shared(mut, []() { return 1; }),
+            event_timer(time_factor() * 100ms, []() { return 2; }));
+        CHECK(result == 1);
+        mut.unlock_shared();
+      }, mut);
+      boson::sleep(time_factor() * 10ms);
+      mut.unlock();
+    });
+  }
+
+  SECTION("Select waits behind writers") {
+    std::vector<int> order;
+    boson::run(1, [&]() {
+      shared_mutex mut;
+      CHECK(mut.lock_shared());
+      start([&](auto mut) -> void {
+        CHECK(mut.lock());
+        order.push_back(1);
+        boson::sleep(time_factor() * 5ms);
+        mut.unlock();
+      }, mut);
+      start([&](auto mut) -> void {
+        boson::sleep(time_factor() * 5ms);
+        int result = select_any(
+            event_lock_shared(mut, []() { return 1; }),
+            event_timer(time_factor() * 100ms, []() { return 2; }));
+        CHECK(result == 1);
+        order.push_back(2);
+        mut.unlock_shared();
+      }, mut);
+      boson::sleep(time_factor() * 10ms);
+      mut.unlock_shared();
+    });
+    REQUIRE(order.size() == 2);
+    CHECK(order[0] == 1);
+    CHECK(order[1] == 2);
+  }
+}
@@ -2,6 +2,8 @@
 #include "boson/boson.h"
 #include "boson/syscalls.h"
 #include "boson/net/socket.h"
+#include "boson/net/sharded_listener.h"
+#include "boson/net/zerocopy.h"
 #include <unistd.h>
 #include <iostream>
 #include "boson/logger.h"
@@ -159,3 +161,193 @@ TEST_CASE("Sockets - Simple accept/connect", "[syscalls][sockets][accept][connec
     });
   }
 }
+
+TEST_CASE("Sockets - Sharded listeners", "[syscalls][sockets][accept]") {
+  auto serve_clients = [](net::listener_sharding sharding) {
+    boson::run(2, [sharding]() {
+      boson::channel<std::nullptr_t, 4> served;
+      auto listeners = net::start_sharded_listeners(
+          10102,
+          [served](int connection) mutable -> void {
+            size_t buffer = 0;
+            boson::recv(connection, &buffer, sizeof(size_t), 0);
+            ++buffer;
+            boson::send(connection, &buffer, sizeof(size_t), 0);
+            boson::close(connection);
+            served << nullptr;
+          },
+          sharding);
+      CHECK(listeners.size() == (sharding == net::listener_sharding::reuse_port ? 2u : 1u));
+
+      struct sockaddr_in cli_addr;
+      cli_addr.sin_addr.s_addr = ::inet_addr("127.0.0.1");
+      cli_addr.sin_family = AF_INET;
+      cli_addr.sin_port = htons(10102);
+      for (size_t index = 0; index < 4; ++index) {
+        int sockfd = boson::socket(AF_INET, SOCK_STREAM, 0);
+        int rc = boson::connect(sockfd, (struct sockaddr*)&cli_addr, sizeof(cli_addr));
+        CHECK(rc == 0);
+        size_t buffer = index;
+        boson::send(sockfd, &buffer, sizeof(size_t), 0);
+        boson::recv(sockfd, &buffer, sizeof(size_t), 0);
+        CHECK(buffer == index + 1);
+        boson::close(sockfd);
+      }
+
+      std::nullptr_t dummy;
+      for (size_t index = 0; index < 4; ++index) CHECK(served >> dummy);
+
+      net::stop_sharded_listeners(listeners);
+    });
+  };
+
+  SECTION("SO_REUSEPORT") {
+    serve_clients(net::listener_sharding::reuse_port);
+  }
+
+  SECTION("EPOLLEXCLUSIVE") {
+    serve_clients(net::listener_sharding::exclusive_wakeup);
+  }
+}
+
+TEST_CASE("Sockets - Batched accept", "[syscalls][sockets][accept]") {
+  // Connects three clients at once, then accepts them
+  auto accept_clients = [](auto accept_batch) {
+    boson::run(1, [accept_batch]() {
+      int listening_socket = boson::net::create_listening_socket(10103);
+      boson::channel<std::nullptr_t, 3> connected;
+      for (size_t index = 0; index < 3; ++index) {
+        start(
+            [](auto connected) -> void {
+              struct sockaddr_in cli_addr;
+              cli_addr.sin_addr.s_addr = ::inet_addr("127.0.0.1");
+              cli_addr.sin_family = AF_INET;
+              cli_addr.sin_port = htons(10103);
+              int sockfd = boson::socket(AF_INET, SOCK_STREAM, 0);
+              int rc = boson::connect(sockfd, (struct sockaddr*)&cli_addr, sizeof(cli_addr));
+              CHECK(rc == 0);
+              connected << nullptr;
+              ::shutdown(sockfd, SHUT_WR);
+              boson::close(sockfd);
+            },
+            connected);
+      }
+      std::nullptr_t dummy;
+      for (size_t index = 0; index < 3; ++index) connected >> dummy;
+
+      std::array<int, 8> sockets;
+      ssize_t nb_accepted = 0;
+      while (nb_accepted < 3) {
+        ssize_t rc = accept_batch(listening_socket, sockets.data() + nb_accepted,
+                                  sockets.size() - nb_accepted);
+        REQUIRE(0 < rc);
+        nb_accepted += rc;
+      }
+      CHECK(nb_accepted == 3);
+      for (ssize_t index = 0; index < nb_accepted; ++index) {
+        // Sockets are non blocking and close-on-exec without any fcntl call
+        CHECK((::fcntl(sockets[index], F_GETFL) & O_NONBLOCK));
+        CHECK((::fcntl(sockets[index], F_GETFD) & FD_CLOEXEC));
+        boson::close(sockets[index]);
+      }
+      boson::close(listening_socket);
+    });
+  };
+
+  SECTION("accept_many") {
+    accept_clients([](int socket, int* sockets, size_t count) {
+      return boson::accept_many(socket, sockets, count, 1000ms);
+    });
+  }
+
+  SECTION("Select on accept_many") {
+    accept_clients([](int socket, int* sockets, size_t count) {
+      return select_any(event_accept_many(socket, sockets, count, [](ssize_t rc) { return rc; }),
+                        event_timer(1000ms, []() { return ssize_t{-1}; }));
+    });
+  }
+}
+
+TEST_CASE("Sockets - UDP", "[syscalls][sockets][udp]") {
+  boson::run(1, []() {
+    int server = boson::net::create_udp_socket(10104, 1 << 16);
+    int client = boson::net::create_udp_socket(0);
+
+    start(
+        [](int server) -> void {
+          // Echo back to the peer, incremented
+          size_t buffer = 0;
+          struct sockaddr_in peer_addr;
+          socklen_t peer_len = sizeof(peer_addr);
+          ssize_t rc = boson::recvfrom(server, &buffer, sizeof(size_t), 0,
+                                       (struct sockaddr*)&peer_addr, &peer_len, 1000ms);
+          CHECK(rc == sizeof(size_t));
+          ++buffer;
+          rc = boson::sendto(server, &buffer, sizeof(size_t), 0, (struct sockaddr*)&peer_addr,
+                             peer_len);
+          CHECK(rc == sizeof(size_t));
+        },
+        server);
+
+    struct sockaddr_in server_addr;
+    server_addr.sin_addr.s_addr = ::inet_addr("127.0.0.1");
+    server_addr.sin_family = AF_INET;
+    server_addr.sin_port = htons(10104);
+    size_t buffer = 1;
+    ssize_t rc = select_any(
+        event_sendto(client, &buffer, sizeof(size_t), 0, (struct sockaddr*)&server_addr,
+                     sizeof(server_addr), [](ssize_t rc) { return rc; }));
+    CHECK(rc == sizeof(size_t));
+
+    struct sockaddr_in peer_addr;
+    socklen_t peer_len = sizeof(peer_addr);
+    rc = select_any(event_recvfrom(client, &buffer, sizeof(size_t), 0,
+                                   (struct sockaddr*)&peer_addr, &peer_len,
+                                   [](ssize_t rc) { return rc; }),
+                    event_timer(1000ms, []() { return ssize_t{-1}; }));
+    CHECK(rc == sizeof(size_t));
+    CHECK(buffer == 2);
+    CHECK(peer_addr.sin_port == htons(10104));
+
+    boson::close(client);
+    boson::close(server);
+  });
+}
+
+TEST_CASE("Sockets - Zero-copy sends", "[syscalls][sockets][zerocopy]") {
+  boson::run(1, []() {
+    int listening_socket = boson::net::create_listening_socket(10105);
+    struct sockaddr_in cli_addr;
+    cli_addr.sin_addr.s_addr = ::inet_addr("127.0.0.1");
+    cli_addr.sin_family = AF_INET;
+    cli_addr.sin_port = htons(10105);
+    int sockfd = boson::socket(AF_INET, SOCK_STREAM, 0);
+    REQUIRE(0 == boson::connect(sockfd, (struct sockaddr*)&cli_addr, sizeof(cli_addr)));
+    int server = boson::accept(listening_socket, nullptr, nullptr);
+    REQUIRE(0 <= server);
+
+    if (0 == net::enable_zerocopy(sockfd)) {
+      std::array<char, 4096> buffer{};
+      CHECK(boson::send(sockfd, buffer.data(), buffer.size(), MSG_ZEROCOPY) == buffer.size());
+      CHECK(boson::send(sockfd, buffer.data(), buffer.size(), MSG_ZEROCOPY) == buffer.size());
+
+      // Every send gets completed
+      uint32_t next_send = 0;
+      while (next_send < 2) {
+        std::array<net::zerocopy_completion, 4> completions;
+        int rc = net::wait_zerocopy_completions(sockfd, completions.data(), completions.size(),
+                                                1000ms);
+        REQUIRE(0 < rc);
+        for (int index = 0; index < rc; ++index) {
+          CHECK(completions[index].first == next_send);
+          next_send = completions[index].last + 1;
+        }
+      }
+      CHECK(next_send == 2);
+    }
+
+    boson::close(server);
+    boson::close(sockfd);
+    boson::close(listening_socket);
+  });
+}
@@ -0,0 +1,92 @@
+#include "catch.hpp"
+#include "boson/boson.h"
+#include "boson/spsc_channel.h"
+#include <iostream>
+#include "boson/logger.h"
+
+using namespace boson;
+using namespace std::literals;
+
+namespace {
+inline int time_factor() {
+#ifdef BOSON_USE_VALGRIND
+  return RUNNING_ON_VALGRIND ? 10 : 1;
+#else
+  return 1;
+#endif
+}
+}
+
+static constexpr int nb_iter = 10000;
+
+TEST_CASE("SPSC channels", "[channels][spsc]") {
+  boson::debug::logger_instance(&std::cout);
+
+  SECTION("Producer and consumer on different threads") {
+    std::vector<int> received;
+    boson::run(2, [&]() {
+      spsc_channel<int> chan(8);
+      start_explicit(1,
+                     [](auto out) -> void {
+                       for (int index = 0; index < nb_iter; ++index) CHECK(out << index);
+                       out.close();
+                     },
+                     chan);
+      int value = 0;
+      while (chan >> value) received.push_back(value);
+    });
+    std::vector<int> expected(nb_iter, 0);
+    for (int index = 0; index < nb_iter; ++index) expected[index] = index;
+    CHECK(received == expected);
+  }
+
+  SECTION("Timeouts") {
+    boson::run(1, [&]() {
+      spsc_channel<int> chan(1);
+      int value = 0;
+      CHECK(chan.read(value, time_factor()) == channel_result_value::timedout);
+      CHECK(chan.write(1));
+      CHECK(chan.write(2, time_factor()) == channel_result_value::timedout);
+      CHECK(chan.read(value));
+      CHECK(value == 1);
+      chan.close();
+      CHECK(chan.write(3) == channel_result_value::closed);
+      CHECK(chan.read(value) == channel_result_value::closed);
+    });
+  }
+
+  SECTION("Select") {
+    std::vector<int> received;
+    boson::run(2, [&]() {
+      spsc_channel<int> data(2);
+      spsc_channel<int> acks(2);
+      start_explicit(1,
+                     [](auto out, auto acks) -> void {
+                       int ack = 0;
+                       for (int index = 0; index < 100; ++index) {
+                         bool written = false;
+                         while (!written) {
+                           select_any(event_write(out, index, [&](bool ok) { written = ok; }),
+                                      event_read(acks, ack, [](bool) {}));
+                         }
+                       }
+                       out.close();
+                     },
+                     data, acks);
+      int value = 0;
+      bool open = true;
+      while (open) {
+        select_any(event_read(data, value,
+                              [&](bool ok) {
+                                open = ok;
+                                if (ok) received.push_back(value);
+                              }),
+                   event_timer(1000, [&]() { open = false; }));
+        if (open) acks.write(value, 0);
+      }
+    });
+    std::vector<int> expected(100, 0);
+    for (int index = 0; index < 100; ++index) expected[index] = index;
+    CHECK(received == expected);
+  }
+}
@@ -7,6 +7,7 @@
 #include "boson/logger.h"
 #include "boson/semaphore.h"
 #include "boson/select.h"
+#include "boson/net/proxy.h"
 
 using namespace boson;
 using namespace std::literals;
@@ -59,3 +60,184 @@ TEST_CASE("Syscalls - File opening", "[syscalls]") {
     CHECK(rc == 0);
   });
 }
+
+TEST_CASE("Syscalls - Vectored I/O", "[syscalls][i/o]") {
+  SECTION("readv/writev") {
+    boson::run(1, []() {
+      int pipe_fds[2];
+      REQUIRE(0 == boson::pipe(pipe_fds));
+      start(
+          [](int out) -> void {
+            // Header and body in a single syscall
+            int header = 2;
+            std::array<char, 2> body{{'o', 'k'}};
+            std::array<iovec, 2> iov{{{&header, sizeof(header)}, {body.data(), body.size()}}};
+            ssize_t rc = boson::writev(out, iov.data(), iov.size());
+            CHECK(rc == sizeof(header) + 2);
+          },
+          pipe_fds[1]);
+      int header = 0;
+      std::array<char, 2> body{};
+      std::array<iovec, 2> iov{{{&header, sizeof(header)}, {body.data(), body.size()}}};
+      ssize_t rc = boson::readv(pipe_fds[0], iov.data(), iov.size(), 1000ms);
+      CHECK(rc == sizeof(header) + 2);
+      CHECK(header == 2);
+      CHECK(std::string(body.data(), body.size()) == "ok");
+      boson::close(pipe_fds[0]);
+      boson::close(pipe_fds[1]);
+    });
+  }
+
+  SECTION("sendmsg/recvmsg and their multi-message versions") {
+    boson::run(1, []() {
+      int sv[2];
+      REQUIRE(0 == ::socketpair(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK, 0, sv));
+
+      // Nothing to read yet
+      int value = 0;
+      iovec iov{&value, sizeof(value)};
+      msghdr message{};
+      message.msg_iov = &iov;
+      message.msg_iovlen = 1;
+      ssize_t rc = boson::recvmsg(sv[1], &message, 0, 5ms);
+      CHECK(rc == -1);
+      CHECK(errno == ETIMEDOUT);
+
+      start(
+          [](int out) -> void {
+            int value = 1;
+            iovec iov{&value, sizeof(value)};
+            msghdr message{};
+            message.msg_iov = &iov;
+            message.msg_iovlen = 1;
+            CHECK(boson::sendmsg(out, &message, 0) == sizeof(int));
+
+            // Three datagrams in a single syscall
+            std::array<int, 3> values{{2, 3, 4}};
+            std::array<iovec, 3> iovs;
+            std::array<mmsghdr, 3> messages{};
+            for (size_t index = 0; index < 3; ++index) {
+              iovs[index] = iovec{&values[index], sizeof(int)};
+              messages[index].msg_hdr.msg_iov = &iovs[index];
+              messages[index].msg_hdr.msg_iovlen = 1;
+            }
+            CHECK(boson::sendmmsg(out, messages.data(), messages.size(), 0) == 3);
+          },
+          sv[0]);
+
+      rc = boson::recvmsg(sv[1], &message, 0);
+      CHECK(rc == sizeof(int));
+      CHECK(value == 1);
+
+      std::array<int, 8> values{};
+      std::array<iovec, 8> iovs;
+      std::array<mmsghdr, 8> messages{};
+      for (size_t index = 0; index < values.size(); ++index) {
+        iovs[index] = iovec{&values[index], sizeof(int)};
+        messages[index].msg_hdr.msg_iov = &iovs[index];
+        messages[index].msg_hdr.msg_iovlen = 1;
+      }
+      int nb_received = select_any(
+          event_recvmmsg(sv[1], messages.data(), messages.size(), 0, [](int rc) { return rc; }),
+          event_timer(1000ms, []() { return -1; }));
+      CHECK(nb_received == 3);
+      CHECK(values[0] == 2);
+      CHECK(values[2] == 4);
+      CHECK(messages[1].msg_len == sizeof(int));
+      boson::close(sv[0]);
+      boson::close(sv[1]);
+    });
+  }
+}
+
+TEST_CASE("Syscalls - Zero-copy transfers", "[syscalls][i/o]") {
+  SECTION("sendfile") {
+    std::array<char, L_tmpnam> filename_buffer;
+    auto filename = std::tmpnam(filename_buffer.data());
+    REQUIRE(filename != nullptr);
+    boson::run(1, [&]() {
+      fd_t file = boson::open(filename, O_RDWR | O_CREAT, 0600);
+      REQUIRE(0 <= file);
+      ::write(file, "hello", 5);
+      int sv[2];
+      REQUIRE(0 == ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, sv));
+      off_t offset = 0;
+      ssize_t rc = boson::sendfile(sv[0], file, &offset, 5, 1000ms);
+      CHECK(rc == 5);
+      std::array<char, 5> buffer{};
+      rc = boson::read(sv[1], buffer.data(), buffer.size());
+      CHECK(std::string(buffer.data(), 5) == "hello");
+      boson::close(sv[0]);
+      boson::close(sv[1]);
+      boson::close(file);
+    });
+    std::remove(filename);
+  }
+
+  SECTION("splice and tee") {
+    boson::run(1, []() {
+      int in_pipe[2], copy_pipe[2], sv[2];
+      REQUIRE(0 == boson::pipe(in_pipe));
+      REQUIRE(0 == boson::pipe(copy_pipe));
+      REQUIRE(0 == ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, sv));
+
+      // Nothing to splice yet, the call must suspend on the input
+      start([](int out) -> void { boson::write(out, "data", 4); }, in_pipe[1]);
+      ssize_t rc = boson::tee(in_pipe[0], copy_pipe[1], 4, 0, 1000ms);
+      CHECK(rc == 4);
+      rc = boson::splice(in_pipe[0], nullptr, sv[0], nullptr, 4, 0);
+      CHECK(rc == 4);
+
+      std::array<char, 4> buffer{};
+      CHECK(boson::read(sv[1], buffer.data(), buffer.size()) == 4);
+      CHECK(std::string(buffer.data(), 4) == "data");
+      CHECK(boson::read(copy_pipe[0], buffer.data(), buffer.size()) == 4);
+      CHECK(std::string(buffer.data(), 4) == "data");
+
+      // Times out
+      rc = boson::splice(in_pipe[0], nullptr, sv[0], nullptr, 4, 0, 5ms);
+      CHECK(rc == -1);
+      CHECK(errno == ETIMEDOUT);
+      for (int fd : {in_pipe[0], in_pipe[1], copy_pipe[0], copy_pipe[1], sv[0], sv[1]})
+        boson::close(fd);
+    });
+  }
+
+  SECTION("Proxy") {
+    boson::run(1, []() {
+      // client <-> proxy_a | proxy_b <-> server
+      int client_side[2], server_side[2];
+      REQUIRE(0 == ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, client_side));
+      REQUIRE(0 == ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, server_side));
+      boson::channel<std::nullptr_t, 1> proxy_done;
+      start(
+          [](int a, int b, auto proxy_done) -> void {
+            net::proxy(a, b);
+            proxy_done << nullptr;
+          },
+          client_side[1], server_side[0], proxy_done);
+
+      // Echo server
+      start(
+          [](int server) -> void {
+            std::array<char, 5> buffer{};
+            ssize_t rc = boson::read(server, buffer.data(), buffer.size());
+            CHECK(rc == 5);
+            boson::write(server, buffer.data(), rc);
+            ::shutdown(server, SHUT_WR);
+          },
+          server_side[1]);
+
+      boson::write(client_side[0], "hello", 5);
+      ::shutdown(client_side[0], SHUT_WR);
+      std::array<char, 8> buffer{};
+      ssize_t rc = boson::read(client_side[0], buffer.data(), buffer.size());
+      CHECK(rc == 5);
+      CHECK(std::string(buffer.data(), 5) == "hello");
+      std::nullptr_t dummy;
+      CHECK(proxy_done >> dummy);
+      for (int fd : {client_side[0], client_side[1], server_side[0], server_side[1]})
+        boson::close(fd);
+    });
+  }
+}
@@ -0,0 +1,92 @@
+#include "catch.hpp"
+#include "boson/boson.h"
+#include <atomic>
+#include "boson/exception.h"
+#include "boson/select.h"
+#include "boson/wait_group.h"
+
+using namespace boson;
+using namespace std::literals;
+
+namespace {
+inline int time_factor() {
+#ifdef BOSON_USE_VALGRIND
+  return RUNNING_ON_VALGRIND ? 10 : 1;
+#else
+  return 1;
+#endif
+}
+}
+
+TEST_CASE("Wait group", "[wait_group]") {
+  SECTION("Join routines") {
+    constexpr int nb_routines = 1000;
+    std::atomic<int> nb_done{0};
+    boson::run(4, [&]() {
+      wait_group group;
+      group.add(nb_routines);
+      for (int index = 0; index < nb_routines; ++index) {
+        start([&](auto group) -> void {
+          nb_done.fetch_add(1);
+          group.done();
+        }, group);
+      }
+      CHECK(group.wait());
+      CHECK(nb_done == nb_routines);
+
+      // Reused
+      group.add();
+      start([](auto group) -> void {
+        boson::sleep(time_factor() * 5ms);
+        group.done();
+      }, group);
+      CHECK(group.wait());
+    });
+  }
+
+  SECTION("Several waiters") {
+    std::atomic<int> nb_woken{0};
+    boson::run(2, [&]() {
+      wait_group group;
+      group.add();
+      for (int index = 0; index < 10; ++index) {
+        start([&](auto group) -> void {
+          CHECK(group.wait());
+          nb_woken.fetch_add(1);
+        }, group);
+      }
+      boson::sleep(time_factor() * 5ms);
+      group.done();
+    });
+    CHECK(nb_woken == 10);
+  }
+
+  SECTION("Timeout") {
+    boson::run(1, [&]() {
+      wait_group group;
+      CHECK(group.wait(0));
+      group.add();
+      CHECK(group.wait(time_factor() * 5ms) == semaphore_return_value::timedout);
+      group.done();
+      CHECK(group.wait());
+      CHECK_THROWS_AS(group.done(), boson::exception);
+    });
+  }
+
+  SECTION("Select") {
+    boson::run(1, [&]() {
+      wait_group group;
+      group.add();
+      start([](auto group) -> void {
+        int result = select_any(event_wait(group, []() { return 1; }),
+                                event_timer(time_factor() * 5ms, []() { return 2; }));
+        CHECK(result == 2);
+        result = select_any(event_wait(group, []() { return 1; }),
+                            event_timer(time_factor() * 100ms, []() { return 2; }));
+        CHECK(result == 1);
+      }, group);
+      boson::sleep(time_factor() * 10ms);
+      group.done();
+    });
+  }
+}